@@ -0,0 +1,168 @@
+/*--------------------------------------------------------------------*/
+/* arena.c                                                            */
+/*--------------------------------------------------------------------*/
+
+#include "arena.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {BLOCK_SIZE = 4096};
+
+/* Allocations are rounded up to a multiple of ALIGNMENT bytes. */
+enum {ALIGNMENT = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* A Block is one chunk of memory from malloc(), followed by its
+   bytes. */
+
+struct Block
+{
+  /* The block allocated before this one. */
+  struct Block *psPrev;
+
+  /* The number of bytes after the header. */
+  size_t uSize;
+};
+
+/* The header is padded so that the bytes after it are aligned. */
+#define BLOCK_HEADER \
+  ((sizeof(struct Block) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+
+/* An Arena consists of a list of blocks, the newest first, and the
+   position of the first free byte in the newest block. */
+
+struct Arena
+{
+  /* The newest block, or NULL if nothing has been allocated. */
+  struct Block *psBlock;
+
+  /* The number of bytes used in psBlock. */
+  size_t uUsed;
+
+  /* The most recent allocation, which Arena_grow() can extend. */
+  void *pvLast;
+};
+
+/*--------------------------------------------------------------------*/
+
+static size_t Arena_round(size_t uSize)
+
+  /* Return uSize rounded up to a multiple of ALIGNMENT. */
+
+{
+  return (uSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+/*--------------------------------------------------------------------*/
+
+Arena_T Arena_new(void)
+
+  /* Return a new, empty Arena_T, or NULL if insufficient memory is
+     available. */
+
+{
+  Arena_T oArena;
+
+  oArena = (struct Arena*)malloc(sizeof(struct Arena));
+  if (oArena == NULL)
+    return NULL;
+  oArena->psBlock = NULL;
+  oArena->uUsed = 0;
+  oArena->pvLast = NULL;
+
+  return oArena;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Arena_free(Arena_T oArena)
+
+  /* Free oArena and every allocation made from it. */
+
+{
+  struct Block *psBlock;
+  struct Block *psPrev;
+
+  if (oArena == NULL)
+    return;
+
+  for (psBlock = oArena->psBlock; psBlock != NULL; psBlock = psPrev)
+  {
+    psPrev = psBlock->psPrev;
+    free(psBlock);
+  }
+  free(oArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *Arena_alloc(Arena_T oArena, size_t uSize)
+
+  /* Return uSize bytes from oArena, aligned for any type, or NULL if
+     insufficient memory is available.
+     It is a checked runtime error for oArena to be NULL. */
+
+{
+  struct Block *psBlock;
+  size_t uBlockSize;
+  void *pv;
+
+  assert(oArena != NULL);
+
+  uSize = Arena_round(uSize);
+  psBlock = oArena->psBlock;
+  if ((psBlock == NULL) || (psBlock->uSize - oArena->uUsed < uSize))
+  {
+    uBlockSize = (uSize > BLOCK_SIZE) ? uSize : BLOCK_SIZE;
+    psBlock = (struct Block*)malloc(BLOCK_HEADER + uBlockSize);
+    if (psBlock == NULL)
+      return NULL;
+    psBlock->psPrev = oArena->psBlock;
+    psBlock->uSize = uBlockSize;
+    oArena->psBlock = psBlock;
+    oArena->uUsed = 0;
+  }
+
+  pv = (char*)psBlock + BLOCK_HEADER + oArena->uUsed;
+  oArena->uUsed += uSize;
+  oArena->pvLast = pv;
+  return pv;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *Arena_grow(Arena_T oArena, void *pvOld, size_t uOldSize,
+    size_t uNewSize)
+
+  /* Return uNewSize bytes from oArena that start with the uOldSize
+     bytes at pvOld, or NULL if insufficient memory is available.
+     pvOld, which may be NULL if uOldSize is 0, must have come from
+     oArena.  If pvOld was the last allocation and its block has room,
+     it is extended in place.
+     It is a checked runtime error for oArena to be NULL. */
+
+{
+  size_t uStart;
+  void *pvNew;
+
+  assert(oArena != NULL);
+  assert((pvOld != NULL) || (uOldSize == 0));
+
+  if ((pvOld != NULL) && (pvOld == oArena->pvLast))
+  {
+    uStart = (size_t)((char*)pvOld -
+                      ((char*)oArena->psBlock + BLOCK_HEADER));
+    if (Arena_round(uNewSize) <= oArena->psBlock->uSize - uStart)
+    {
+      oArena->uUsed = uStart + Arena_round(uNewSize);
+      return pvOld;
+    }
+  }
+
+  pvNew = Arena_alloc(oArena, uNewSize);
+  if ((pvNew != NULL) && (uOldSize > 0))
+    memcpy(pvNew, pvOld, (uOldSize < uNewSize) ? uOldSize : uNewSize);
+  return pvNew;
+}
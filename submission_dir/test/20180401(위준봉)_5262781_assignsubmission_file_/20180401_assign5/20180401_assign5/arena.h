@@ -0,0 +1,36 @@
+/*--------------------------------------------------------------------*/
+/* arena.h                                                            */
+/*--------------------------------------------------------------------*/
+
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <stddef.h>
+
+typedef struct Arena *Arena_T;
+/* An Arena_T hands out memory by bumping a pointer through large
+   blocks.  Its allocations are not freed one by one; freeing the
+   Arena_T releases all of them at once. */
+
+Arena_T Arena_new(void);
+/* Return a new, empty Arena_T, or NULL if insufficient memory is
+   available. */
+
+void Arena_free(Arena_T oArena);
+/* Free oArena and every allocation made from it. */
+
+void *Arena_alloc(Arena_T oArena, size_t uSize);
+/* Return uSize bytes from oArena, aligned for any type, or NULL if
+   insufficient memory is available.
+   It is a checked runtime error for oArena to be NULL. */
+
+void *Arena_grow(Arena_T oArena, void *pvOld, size_t uOldSize,
+    size_t uNewSize);
+/* Return uNewSize bytes from oArena that start with the uOldSize bytes
+   at pvOld, or NULL if insufficient memory is available.  pvOld, which
+   may be NULL if uOldSize is 0, must have come from oArena.  If pvOld
+   was the last allocation and its block has room, it is extended in
+   place.
+   It is a checked runtime error for oArena to be NULL. */
+
+#endif
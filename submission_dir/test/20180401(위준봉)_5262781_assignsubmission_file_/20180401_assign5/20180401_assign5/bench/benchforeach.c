@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------*/
+/* benchforeach.c                                                     */
+/* Times a pass over a token array, counting its pipes as countPipe() */
+/* did, with DynArray_getLength() and DynArray_get() per element,     */
+/* against DYNARRAY_FOREACH and a DynArray_data() loop.               */
+/*--------------------------------------------------------------------*/
+
+#include "../dynarray.h"
+#include "../token.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Each length is passed over WORK_PER_SIZE / length times. */
+enum {WORK_PER_SIZE = 50000000};
+
+static double seconds(void)
+
+  /* Return the time of a monotonic clock, in seconds. */
+
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec / 1e9;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int countWithGet(DynArray_T oTokens)
+{
+  int iCount = 0, i;
+  struct Token *t;
+
+  for (i = 0; i < DynArray_getLength(oTokens); i++) {
+    t = DynArray_get(oTokens, i);
+    if (t->eType == TOKEN_PIPE)
+      iCount++;
+  }
+  return iCount;
+}
+
+static int countWithForeach(DynArray_T oTokens)
+{
+  int iCount = 0;
+  struct Token *t;
+
+  DYNARRAY_FOREACH(t, oTokens) {
+    if (t->eType == TOKEN_PIPE)
+      iCount++;
+  }
+  return iCount;
+}
+
+static int countWithData(DynArray_T oTokens)
+{
+  void **ppvTokens = DynArray_data(oTokens);
+  int iLength = DynArray_size(oTokens);
+  int iCount = 0, i;
+
+  for (i = 0; i < iLength; i++)
+    if (((struct Token*)ppvTokens[i])->eType == TOKEN_PIPE)
+      iCount++;
+  return iCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+static double timeCount(int (*pfCount)(DynArray_T oTokens),
+    DynArray_T oTokens, int iExpected)
+
+  /* Return the mean time in nanoseconds per token for *pfCount to
+     count the pipes of oTokens, exiting if it miscounts. */
+
+{
+  int iLength = DynArray_getLength(oTokens);
+  int iRounds = WORK_PER_SIZE / iLength;
+  double dStart;
+  int i;
+
+  dStart = seconds();
+  for (i = 0; i < iRounds; i++)
+    if ((*pfCount)(oTokens) != iExpected)
+    {
+      fprintf(stderr, "benchforeach: miscounted\n");
+      exit(EXIT_FAILURE);
+    }
+  return (seconds() - dStart) * 1e9 / ((double)iRounds * iLength);
+}
+
+int main(void)
+
+  /* Print the time per token of each way of counting, for a short
+     command line, a long one, and a very long one. */
+
+{
+  static const int aiLengths[] = {8, 64, 4096};
+  DynArray_T oTokens;
+  struct Token *psToken;
+  double dGet, dForeach, dData;
+  size_t u;
+  int iPipes;
+  int i;
+
+  printf("%-7s %12s %12s %12s %9s\n", "tokens", "get ns/tok",
+         "foreach", "data", "speedup");
+  for (u = 0; u < sizeof(aiLengths) / sizeof(aiLengths[0]); u++)
+  {
+    /* "word word word | word word word | ..." */
+    oTokens = DynArray_new(0);
+    iPipes = 0;
+    for (i = 0; i < aiLengths[u]; i++)
+    {
+      if (i % 4 == 3)
+      {
+        psToken = makeToken(TOKEN_PIPE, NULL);
+        iPipes++;
+      }
+      else
+        psToken = makeToken(TOKEN_WORD, "word");
+      DynArray_add(oTokens, psToken);
+    }
+
+    dGet = timeCount(countWithGet, oTokens, iPipes);
+    dForeach = timeCount(countWithForeach, oTokens, iPipes);
+    dData = timeCount(countWithData, oTokens, iPipes);
+    printf("%-7d %12.2f %12.2f %12.2f %8.1fx\n", aiLengths[u], dGet,
+           dForeach, dData, dGet / dForeach);
+
+    DynArray_map(oTokens, freeToken, NULL);
+    DynArray_free(oTokens);
+  }
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*--------------------------------------------------------------------*/
+/* benchindex.c                                                       */
+/* Times DynIndex_search() against DynArray_bsearch() on sorted       */
+/* string tables of 1e3, 1e5 and 1e7 keys.                            */
+/*--------------------------------------------------------------------*/
+
+#include "../dynarray.h"
+#include "../dynindex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of lookups timed at each size, and the room for one
+   key. */
+enum {LOOKUPS = 1000000};
+enum {KEY_SIZE = 20};
+
+static double seconds(void)
+
+  /* Return the time of a monotonic clock, in seconds. */
+
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec / 1e9;
+}
+
+static int compareKeys(const void *pvOne, const void *pvTwo)
+{
+  return strcmp((const char*)pvOne, (const char*)pvTwo);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void makeKey(char *pcKey, const char *pcPrefix, long lValue)
+
+  /* Write to pcKey pcPrefix followed by lValue spelled in eight
+     letters, most significant first, so that keys made from increasing
+     values are in increasing order. */
+
+{
+  char *pc;
+  int i;
+
+  strcpy(pcKey, pcPrefix);
+  pc = pcKey + strlen(pcPrefix);
+  for (i = 7; i >= 0; i--)
+  {
+    pc[i] = (char)('a' + lValue % 26);
+    lValue /= 26;
+  }
+  pc[8] = '\0';
+}
+
+static void benchKeys(int iLength, const char *pcPrefix, char *pcKeys,
+    int *piQueries)
+
+  /* Time lookups of the keys piQueries[0...LOOKUPS-1] in a table of
+     iLength keys that start with pcPrefix, and print a line. */
+
+{
+  /* 26^8 spread over the table, so the letters vary from the first
+     one on. */
+  const long lSpan = 208827064576L;
+  DynArray_T oDynArray;
+  DynIndex_T oDynIndex;
+  double dStart, dBsearch, dIndex;
+  long lSum = 0;
+  int i;
+
+  oDynArray = DynArray_newWithCapacity(iLength);
+  for (i = 0; i < iLength; i++)
+  {
+    makeKey(pcKeys + (size_t)i * KEY_SIZE, pcPrefix,
+        (long)((double)lSpan / iLength * i));
+    DynArray_add(oDynArray, pcKeys + (size_t)i * KEY_SIZE);
+  }
+  oDynIndex = DynIndex_new(oDynArray, NULL);
+  if (oDynIndex == NULL)
+  {
+    fprintf(stderr, "benchindex: out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  dStart = seconds();
+  for (i = 0; i < LOOKUPS; i++)
+    lSum += DynArray_bsearch(oDynArray,
+        pcKeys + (size_t)piQueries[i] * KEY_SIZE, compareKeys);
+  dBsearch = seconds() - dStart;
+
+  dStart = seconds();
+  for (i = 0; i < LOOKUPS; i++)
+    lSum -= DynIndex_search(oDynIndex,
+        pcKeys + (size_t)piQueries[i] * KEY_SIZE);
+  dIndex = seconds() - dStart;
+
+  /* Both found the same keys at the same places. */
+  if (lSum != 0)
+  {
+    fprintf(stderr, "benchindex: results differ\n");
+    exit(EXIT_FAILURE);
+  }
+  printf("%-9d %-10s %12.1f %12.1f %8.2fx\n", iLength,
+         (*pcPrefix == '\0') ? "distinct" : "shared", dBsearch * 1e9 /
+         LOOKUPS, dIndex * 1e9 / LOOKUPS, dBsearch / dIndex);
+  fflush(stdout);
+
+  DynIndex_free(oDynIndex);
+  DynArray_free(oDynArray);
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+
+  /* Print the time per lookup at 1e3, 1e5 and 1e7 keys, or up to the
+     number given as argv[1].  The "distinct" keys differ in their
+     first eight bytes; the "shared" ones all start with "/usr/bin/",
+     so that the inline prefixes of DynIndex do not tell them apart. */
+
+{
+  int iMaxLength = 10000000;
+  int *piQueries;
+  char *pcKeys;
+  int iLength;
+  int i;
+
+  if (argc > 1)
+    iMaxLength = atoi(argv[1]);
+  pcKeys = (char*)malloc((size_t)iMaxLength * KEY_SIZE);
+  piQueries = (int*)malloc(sizeof(int) * LOOKUPS);
+  if ((pcKeys == NULL) || (piQueries == NULL))
+  {
+    fprintf(stderr, "%s: out of memory\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  printf("%-9s %-10s %12s %12s %9s\n", "keys", "prefixes",
+         "bsearch ns", "index ns", "speedup");
+  for (iLength = 1000; iLength <= iMaxLength; iLength *= 100)
+  {
+    srand(1);
+    for (i = 0; i < LOOKUPS; i++)
+      piQueries[i] = (int)(((double)rand() / ((double)RAND_MAX + 1)) *
+                           iLength);
+    benchKeys(iLength, "", pcKeys, piQueries);
+    benchKeys(iLength, "/usr/bin/", pcKeys, piQueries);
+  }
+
+  free(piQueries);
+  free(pcKeys);
+  return 0;
+}
@@ -0,0 +1,133 @@
+/*--------------------------------------------------------------------*/
+/* benchpipeline.c                                                    */
+/* Times ../ish running pipelines of 2 to 64 cat stages, with each    */
+/* launch backend, against /bin/sh running the same lines.            */
+/*--------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Each shell reads LINES copies of the pipeline, so that its own
+   start-up is spread over many of them. */
+enum {LINES = 100};
+enum {MAX_STAGES = 64};
+
+static double seconds(void)
+
+  /* Return the time of a monotonic clock, in seconds. */
+
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec / 1e9;
+}
+
+/*--------------------------------------------------------------------*/
+
+static void writeScript(FILE *psFile, int iStages)
+
+  /* Replace the contents of psFile with LINES lines of
+     "cat < /dev/null | cat | ... | cat", of iStages stages. */
+
+{
+  int i, j;
+
+  rewind(psFile);
+  if (ftruncate(fileno(psFile), 0) < 0)
+  {
+    perror("benchpipeline: ftruncate");
+    exit(EXIT_FAILURE);
+  }
+  for (i = 0; i < LINES; i++)
+  {
+    fputs("cat < /dev/null", psFile);
+    for (j = 1; j < iStages; j++)
+      fputs(" | cat", psFile);
+    fputc('\n', psFile);
+  }
+  fflush(psFile);
+}
+
+static double timeShell(const char *pcShell, const char *pcBackend,
+    FILE *psScript)
+
+  /* Return the mean time in microseconds per line for pcShell to run
+     the lines of psScript from its stdin, with ISH_LAUNCH set to
+     pcBackend if it is not NULL.  Exit if the shell fails. */
+
+{
+  double dStart;
+  int iStatus;
+  pid_t pid;
+
+  fflush(stdout);
+  dStart = seconds();
+  pid = fork();
+  if (pid < 0)
+  {
+    perror("benchpipeline: fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0)
+  {
+    if (pcBackend != NULL)
+      setenv("ISH_LAUNCH", pcBackend, 1);
+    lseek(fileno(psScript), 0, SEEK_SET);
+    dup2(fileno(psScript), STDIN_FILENO);
+    close(STDOUT_FILENO);
+    open("/dev/null", O_WRONLY);
+    execl(pcShell, pcShell, (char*)NULL);
+    _exit(127);
+  }
+  if ((waitpid(pid, &iStatus, 0) != pid) || ! WIFEXITED(iStatus) ||
+      (WEXITSTATUS(iStatus) != 0))
+  {
+    fprintf(stderr, "benchpipeline: %s failed\n", pcShell);
+    exit(EXIT_FAILURE);
+  }
+  return (seconds() - dStart) * 1e6 / LINES;
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Print the time per pipeline of 2, 4, ... 64 stages for ish with
+     posix_spawn(), ish with fork(), and /bin/sh. */
+
+{
+  double dSpawn, dFork, dSh;
+  FILE *psScript;
+  int iStages;
+
+  psScript = tmpfile();
+  if (psScript == NULL)
+  {
+    perror("benchpipeline: tmpfile");
+    return EXIT_FAILURE;
+  }
+
+  printf("%-7s %12s %12s %12s %12s\n", "stages", "spawn us", "fork us",
+         "sh us", "spawn us/st");
+  for (iStages = 2; iStages <= MAX_STAGES; iStages *= 2)
+  {
+    writeScript(psScript, iStages);
+    dSpawn = timeShell("../ish", "spawn", psScript);
+    dFork = timeShell("../ish", "fork", psScript);
+    dSh = timeShell("/bin/sh", NULL, psScript);
+    printf("%-7d %12.1f %12.1f %12.1f %12.1f\n", iStages, dSpawn, dFork,
+           dSh, dSpawn / iStages);
+    fflush(stdout);
+  }
+
+  fclose(psScript);
+  return 0;
+}
@@ -0,0 +1,217 @@
+/*--------------------------------------------------------------------*/
+/* benchsort.c                                                        */
+/* Times DynArray_sort(), the C library's qsort() and the             */
+/* last-element-pivot quicksort that DynArray_sort() used before, on  */
+/* sorted, reversed and random input.                                 */
+/*--------------------------------------------------------------------*/
+
+#include "../dynarray.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The old quicksort is quadratic, with recursion as deep as the array
+   is long, on sorted and reversed input; it runs those only up to
+   OLD_MAX_SORTED elements. */
+enum {OLD_MAX_SORTED = 10000};
+
+/* Each length is sorted WORK_PER_SIZE / length times, at least once,
+   so that short sorts are not lost in the clock's noise. */
+enum {WORK_PER_SIZE = 2000000};
+
+static int *piValues;
+
+static double seconds(void)
+
+  /* Return the time of a monotonic clock, in seconds. */
+
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec / 1e9;
+}
+
+static int compareInts(const void *pvOne, const void *pvTwo)
+{
+  int iOne = *(const int*)pvOne;
+  int iTwo = *(const int*)pvTwo;
+
+  return (iOne > iTwo) - (iOne < iTwo);
+}
+
+static int compareIntRefs(const void *pvOne, const void *pvTwo)
+{
+  return compareInts(*(const void *const *)pvOne,
+                     *(const void *const *)pvTwo);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The sort of the original dynarray.c, kept here for comparison. */
+
+static void oldSwap(const void *ppvArray[], int iOne, int iTwo)
+{
+  const void *pvTemp;
+  pvTemp = ppvArray[iOne];
+  ppvArray[iOne] = ppvArray[iTwo];
+  ppvArray[iTwo] = pvTemp;
+}
+
+static int oldPartition(const void *ppvArray[], int iLeft, int iRight,
+    int (*pfCompare)(const void *pvElement1, const void *pvElement2))
+{
+  int iFirst = iLeft-1;
+  int iLast = iRight;
+
+  while (1)
+  {
+    while ((*pfCompare)(ppvArray[++iFirst], ppvArray[iRight]) < 0)
+      ;
+    while ((*pfCompare)(ppvArray[iRight], ppvArray[--iLast]) < 0)
+      if (iLast == iLeft)
+        break;
+    if (iFirst >= iLast)
+      break;
+    oldSwap(ppvArray, iFirst, iLast);
+  }
+  oldSwap(ppvArray, iFirst, iRight);
+  return iFirst;
+}
+
+static void oldQuicksort(const void *ppvArray[], int iLeft, int iRight,
+    int (*pfCompare)(const void *pvElement1, const void *pvElement2))
+{
+  int iMid;
+  if (iRight > iLeft)
+  {
+    iMid = oldPartition(ppvArray, iLeft, iRight, pfCompare);
+    oldQuicksort(ppvArray, iLeft, iMid - 1, pfCompare);
+    oldQuicksort(ppvArray, iMid + 1, iRight, pfCompare);
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+enum Sorter {SORT, QSORT, OLD_QUICKSORT, SORTERS};
+enum Pattern {SORTED, REVERSED, RANDOM, PATTERNS};
+
+static const char *const apcSorters[SORTERS] =
+  {"sort", "qsort", "old quicksort"};
+static const char *const apcPatterns[PATTERNS] =
+  {"sorted", "reversed", "random"};
+
+static void fill(DynArray_T oDynArray, int iLength, enum Pattern ePattern)
+
+  /* Make oDynArray hold iLength elements of piValues in the order
+     ePattern names. */
+
+{
+  int i;
+
+  for (i = 0; i < iLength; i++)
+    switch (ePattern)
+    {
+      case SORTED: DynArray_set(oDynArray, i, &piValues[i]); break;
+      case REVERSED:
+        DynArray_set(oDynArray, i, &piValues[iLength - 1 - i]);
+        break;
+      default:
+        DynArray_set(oDynArray, i, &piValues[rand() % iLength]);
+        break;
+    }
+}
+
+static double timeSort(enum Sorter eSorter, enum Pattern ePattern,
+    int iLength)
+
+  /* Return the mean time in milliseconds for eSorter to sort iLength
+     elements in order ePattern, or a negative number if it is not
+     run.  Random input is drawn with repetition. */
+
+{
+  DynArray_T oDynArray;
+  double dTotal = 0;
+  double dStart;
+  int iRounds;
+  int i;
+
+  if ((eSorter == OLD_QUICKSORT) && (ePattern != RANDOM) &&
+      (iLength > OLD_MAX_SORTED))
+    return -1;
+
+  iRounds = WORK_PER_SIZE / iLength;
+  if (iRounds < 1)
+    iRounds = 1;
+  oDynArray = DynArray_new(iLength);
+  srand(1);
+  for (i = 0; i < iRounds; i++)
+  {
+    fill(oDynArray, iLength, ePattern);
+    dStart = seconds();
+    switch (eSorter)
+    {
+      case SORT: DynArray_sort(oDynArray, compareInts); break;
+      case QSORT:
+        qsort(DynArray_data(oDynArray), (size_t)iLength, sizeof(void*),
+            compareIntRefs);
+        break;
+      default:
+        oldQuicksort((const void**)DynArray_data(oDynArray), 0,
+            iLength - 1, compareInts);
+        break;
+    }
+    dTotal += seconds() - dStart;
+  }
+  DynArray_free(oDynArray);
+  return dTotal * 1000 / iRounds;
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+
+  /* Print a table of sort times for lengths 1e3, 1e5 and 1e7, or up
+     to the length given as argv[1]. */
+
+{
+  int iMaxLength = 10000000;
+  int iLength;
+  int iSorter;
+  int iPattern;
+  double dMs;
+  int i;
+
+  if (argc > 1)
+    iMaxLength = atoi(argv[1]);
+  piValues = (int*)malloc(sizeof(int) * (size_t)iMaxLength);
+  if (piValues == NULL)
+  {
+    fprintf(stderr, "%s: out of memory\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  for (i = 0; i < iMaxLength; i++)
+    piValues[i] = i;
+
+  printf("%-9s %-14s %-9s %12s\n", "length", "sorter", "input",
+         "ms/sort");
+  for (iLength = 1000; iLength <= iMaxLength; iLength *= 100)
+    for (iSorter = 0; iSorter < SORTERS; iSorter++)
+      for (iPattern = 0; iPattern < PATTERNS; iPattern++)
+      {
+        dMs = timeSort((enum Sorter)iSorter, (enum Pattern)iPattern,
+            iLength);
+        if (dMs < 0)
+          printf("%-9d %-14s %-9s %12s\n", iLength, apcSorters[iSorter],
+                 apcPatterns[iPattern], "(quadratic)");
+        else
+          printf("%-9d %-14s %-9s %12.3f\n", iLength, apcSorters[iSorter],
+                 apcPatterns[iPattern], dMs);
+        fflush(stdout);
+      }
+
+  free(piValues);
+  return 0;
+}
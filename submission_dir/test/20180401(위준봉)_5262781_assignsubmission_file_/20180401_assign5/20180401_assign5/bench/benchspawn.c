@@ -0,0 +1,110 @@
+/*--------------------------------------------------------------------*/
+/* benchspawn.c                                                       */
+/* Times launch_command() starting and reaping /bin/true with the     */
+/* posix_spawn() and the fork() backends, as the heap of the calling  */
+/* process grows.                                                     */
+/*--------------------------------------------------------------------*/
+
+#include "../launch.h"
+#include "../symbol.h"
+#include "../util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of commands started for each heap size and backend. */
+enum {LAUNCHES = 200};
+
+static double seconds(void)
+
+  /* Return the time of a monotonic clock, in seconds. */
+
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec / 1e9;
+}
+
+/*--------------------------------------------------------------------*/
+
+static double timeLaunches(const char *pcBackend)
+
+  /* Return the mean time in microseconds to start /bin/true through
+     launch_command() with ISH_LAUNCH set to pcBackend, and wait for
+     it, exiting if a launch fails. */
+
+{
+  char *apcArgv[] = {"/bin/true", NULL};
+  double dStart;
+  int iStatus;
+  int iPid;
+  int i;
+
+  setenv("ISH_LAUNCH", pcBackend, 1);
+  dStart = seconds();
+  for (i = 0; i < LAUNCHES; i++)
+  {
+    iPid = launch_command(apcArgv, SYMBOL_NONE, FD_IN, FD_OUT);
+    if ((iPid < 0) || (waitpid(iPid, &iStatus, 0) != iPid) ||
+        ! WIFEXITED(iStatus) || (WEXITSTATUS(iStatus) != 0))
+    {
+      fprintf(stderr, "benchspawn: launch failed\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  return (seconds() - dStart) * 1e6 / LAUNCHES;
+}
+
+int main(int argc, char *argv[])
+
+  /* Print the time per launch of each backend with 0, 256 MB, 1 GB
+     and 2 GB of touched heap, or up to the number of megabytes given
+     as argv[1]. */
+
+{
+  static const size_t auHeapMb[] = {0, 256, 1024, 2048};
+  size_t uMaxMb = 2048;
+  double dSpawn, dFork;
+  char *pcHeap = NULL;
+  size_t u;
+
+  errorPrint(argv[0], SETUP);
+  if (argc > 1)
+    uMaxMb = (size_t)atol(argv[1]);
+
+  printf("%-8s %12s %12s %9s\n", "heap MB", "spawn us", "fork us",
+         "speedup");
+  for (u = 0; u < sizeof(auHeapMb) / sizeof(auHeapMb[0]); u++)
+  {
+    if (auHeapMb[u] > uMaxMb)
+      break;
+
+    /* Touch every page, so that fork() has them all to map. */
+    free(pcHeap);
+    pcHeap = NULL;
+    if (auHeapMb[u] > 0)
+    {
+      pcHeap = (char*)malloc(auHeapMb[u] << 20);
+      if (pcHeap == NULL)
+      {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return EXIT_FAILURE;
+      }
+      memset(pcHeap, 1, auHeapMb[u] << 20);
+    }
+
+    dSpawn = timeLaunches("spawn");
+    dFork = timeLaunches("fork");
+    printf("%-8lu %12.1f %12.1f %8.1fx\n", (unsigned long)auHeapMb[u],
+           dSpawn, dFork, dFork / dSpawn);
+    fflush(stdout);
+  }
+
+  free(pcHeap);
+  return 0;
+}
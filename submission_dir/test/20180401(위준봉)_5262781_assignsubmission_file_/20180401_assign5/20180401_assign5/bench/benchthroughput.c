@@ -0,0 +1,158 @@
+/*--------------------------------------------------------------------*/
+/* benchthroughput.c                                                  */
+/* Times ../ish moving gigabytes through pipelines of cat and tee     */
+/* stages: with ordinary pipes, with ISH_PIPE_SIZE=max, and with      */
+/* ISH_RELAY=1 as well.                                               */
+/*--------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+enum {MAX_LINE = 256};
+
+/* The pipelines, with %ld where the number of bytes goes.  The first
+   and last stages always run as commands; the ones between may be
+   relayed. */
+static const char *const apcPipelines[] = {
+  "head -c %ld /dev/zero | wc -c",
+  "head -c %ld /dev/zero | cat | wc -c",
+  "head -c %ld /dev/zero | cat | cat | cat | wc -c",
+  "head -c %ld /dev/zero | tee /dev/null | cat | wc -c"
+};
+
+static double seconds(void)
+
+  /* Return the time of a monotonic clock, in seconds. */
+
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec / 1e9;
+}
+
+/*--------------------------------------------------------------------*/
+
+static double timeLine(const char *pcLine, const char *pcPipeSize,
+    const char *pcRelay, long lBytes)
+
+  /* Return the time in seconds for ../ish to run pcLine, with
+     ISH_PIPE_SIZE set to pcPipeSize and ISH_RELAY to pcRelay, or unset
+     if they are NULL.  Exit if the shell fails or the line does not
+     count lBytes bytes. */
+
+{
+  char acOutput[MAX_LINE];
+  int aiIn[2], aiOut[2];
+  double dStart, dSeconds;
+  size_t uLength = 0;
+  char *pc;
+  ssize_t n;
+  int iStatus;
+  pid_t pid;
+
+  if ((pipe(aiIn) < 0) || (pipe(aiOut) < 0))
+  {
+    perror("benchthroughput: pipe");
+    exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  dStart = seconds();
+  pid = fork();
+  if (pid < 0)
+  {
+    perror("benchthroughput: fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0)
+  {
+    if (pcPipeSize != NULL)
+      setenv("ISH_PIPE_SIZE", pcPipeSize, 1);
+    else
+      unsetenv("ISH_PIPE_SIZE");
+    if (pcRelay != NULL)
+      setenv("ISH_RELAY", pcRelay, 1);
+    else
+      unsetenv("ISH_RELAY");
+    dup2(aiIn[0], STDIN_FILENO);
+    dup2(aiOut[1], STDOUT_FILENO);
+    close(aiIn[0]);
+    close(aiIn[1]);
+    close(aiOut[0]);
+    close(aiOut[1]);
+    execl("../ish", "ish", (char*)NULL);
+    _exit(127);
+  }
+
+  close(aiIn[0]);
+  close(aiOut[1]);
+  if ((write(aiIn[1], pcLine, strlen(pcLine)) < 0) ||
+      (write(aiIn[1], "\n", 1) < 0))
+  {
+    perror("benchthroughput: write");
+    exit(EXIT_FAILURE);
+  }
+  close(aiIn[1]);
+  while ((uLength < sizeof(acOutput) - 1) &&
+         ((n = read(aiOut[0], acOutput + uLength,
+                    sizeof(acOutput) - 1 - uLength)) > 0))
+    uLength += (size_t)n;
+  close(aiOut[0]);
+  acOutput[uLength] = '\0';
+  if ((waitpid(pid, &iStatus, 0) != pid) || ! WIFEXITED(iStatus) ||
+      (WEXITSTATUS(iStatus) != 0))
+  {
+    fprintf(stderr, "benchthroughput: ish failed\n");
+    exit(EXIT_FAILURE);
+  }
+  dSeconds = seconds() - dStart;
+
+  /* The output is the prompts and the count wc printed. */
+  pc = acOutput + strcspn(acOutput, "0123456789");
+  if (strtol(pc, NULL, 10) != lBytes)
+  {
+    fprintf(stderr, "benchthroughput: \"%s\" counted \"%s\"\n", pcLine,
+            acOutput);
+    exit(EXIT_FAILURE);
+  }
+  return dSeconds;
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+
+  /* Print the throughput of each pipeline moving 4 GB, or the number of
+     megabytes given as argv[1], with ordinary pipes, with
+     ISH_PIPE_SIZE=max, and with ISH_RELAY=1 as well. */
+
+{
+  long lBytes = 4096L << 20;
+  char acLine[MAX_LINE];
+  double dDefault, dMax, dRelay;
+  size_t u;
+
+  if (argc > 1)
+    lBytes = atol(argv[1]) << 20;
+
+  printf("%-58s %12s %12s %12s\n", "pipeline", "default", "max",
+         "max+relay");
+  for (u = 0; u < sizeof(apcPipelines) / sizeof(apcPipelines[0]); u++)
+  {
+    snprintf(acLine, sizeof(acLine), apcPipelines[u], lBytes);
+    dDefault = timeLine(acLine, NULL, NULL, lBytes);
+    dMax = timeLine(acLine, "max", NULL, lBytes);
+    dRelay = timeLine(acLine, "max", "1", lBytes);
+    printf("%-58s %7.2f GB/s %7.2f GB/s %7.2f GB/s\n", acLine,
+           lBytes / dDefault / (1 << 30), lBytes / dMax / (1 << 30),
+           lBytes / dRelay / (1 << 30));
+    fflush(stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,891 @@
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "builtin.h"
+#include "parsecache.h"
+#include "pathcache.h"
+#include "symbol.h"
+#include "util.h"
+
+enum {MAX_MESSAGE_SIZE = 1024};
+
+/*--------------------------------------------------------------------*/
+/* The handlers.  Each takes the words of its stage and returns an exit
+   status.  The shell runs a BUILTIN_PARENT builtin only on a line of
+   its own words, with no pipe, redirection or '&'; on any other line
+   it reports the builtin's usage message instead. */
+
+static int
+usageError(const char *pcName) {
+  /* Report the usage message of builtin pcName.  Return EXIT_FAILURE. */
+  errorPrint((char *)Builtin_lookup(pcName, strlen(pcName))->pcUsage,
+             FPRINTF);
+  return EXIT_FAILURE;
+}
+
+static int
+runExit(int argc, char *argv[]) {
+  (void)argc;
+  (void)argv;
+  ParseCache_dumpStats();
+  exit(EXIT_SUCCESS);
+}
+
+static void
+changedEnv(const char *pcName) {
+  /* Drop what depended on environment variable pcName, which has just
+     been set or unset. */
+  if (strcmp(pcName, "PATH") == 0)
+    PathCache_clear();
+}
+
+static int
+runSetenv(int argc, char *argv[]) {
+  if (argc == 2 || argc == 3)
+    changedEnv(argv[1]);
+  switch (argc) {
+  case 2:
+    if (setenv(argv[1], "", 1) < 0) {
+      errorPrint(strerror(errno), FPRINTF);
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  case 3:
+    if (setenv(argv[1], argv[2], 1) < 0) {
+      errorPrint(strerror(errno), FPRINTF);
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  default:
+    return usageError(argv[0]);
+  }
+}
+
+static int
+runUnsetenv(int argc, char *argv[]) {
+  if (argc != 2)
+    return usageError(argv[0]);
+  changedEnv(argv[1]);
+  if (unsetenv(argv[1]) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int
+runCd(int argc, char *argv[]) {
+  switch (argc) {
+  case 1:
+    if (chdir(getenv("HOME")) < 0) {
+      errorPrint(strerror(errno), FPRINTF);
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  case 2:
+    if (chdir(argv[1]) < 0) {
+      errorPrint(strerror(errno), FPRINTF);
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  default:
+    return usageError(argv[0]);
+  }
+}
+
+static int
+runHash(int argc, char *argv[]) {
+  /* hash: list the remembered commands.  hash -r: forget them all.
+     hash NAME...: look each NAME up in PATH again and remember it. */
+  char acMessage[MAX_MESSAGE_SIZE];
+  Arena_T oPaths;
+  int status = EXIT_SUCCESS;
+  int i;
+
+  if (argc == 1) {
+    PathCache_print(stdout);
+    return EXIT_SUCCESS;
+  }
+  if (argc == 2 && strcmp(argv[1], "-r") == 0) {
+    PathCache_clear();
+    return EXIT_SUCCESS;
+  }
+  if ((oPaths = Arena_new()) == NULL) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    return EXIT_FAILURE;
+  }
+  for (i = 1; i < argc; i++) {
+    PathCache_forget(argv[i]);
+    if (PathCache_resolve(argv[i], SYMBOL_NONE, oPaths) == NULL) {
+      snprintf(acMessage, sizeof(acMessage), "hash: %s: not found", argv[i]);
+      errorPrint(acMessage, FPRINTF);
+      status = EXIT_FAILURE;
+    }
+  }
+  Arena_free(oPaths);
+  return status;
+}
+
+static int
+runRehash(int argc, char *argv[]) {
+  if (argc != 1)
+    return usageError(argv[0]);
+  PathCache_clear();
+  return EXIT_SUCCESS;
+}
+
+static int
+runFg(int argc, char *argv[]) {
+  (void)argc;
+  (void)argv;
+  errorPrint("Not implemented", FPRINTF);
+  return EXIT_FAILURE;
+}
+
+/*--------------------------------------------------------------------*/
+/* The POSIX utilities the shell runs in-process: echo, true, false,
+   printf, test and pwd.  They only write to stdout, so the shell runs
+   them itself with their redirections swapped in, and forks for them
+   only when they are a stage of a pipeline. */
+
+static int
+finishOutput(const char *pcName) {
+  /* Flush what builtin pcName wrote.  Return its exit status. */
+  char acMessage[MAX_MESSAGE_SIZE];
+
+  if (fflush(stdout) == EOF || ferror(stdout)) {
+    snprintf(acMessage, sizeof(acMessage), "%s: write error: %s", pcName,
+             strerror(errno));
+    errorPrint(acMessage, FPRINTF);
+    clearerr(stdout);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+static int
+putEscape(FILE *fp, const char **ppc, int iEchoStyle) {
+  /* Write the character that the backslash escape at *ppc stands for
+     to fp, and move *ppc past the escape.  Octal escapes are \NNN, and
+     also \0NNN if iEchoStyle is set, as for echo -e and %b.
+     Return TRUE if the escape is \c, which ends all output. */
+  const char *pc = *ppc + 1;
+  int iValue = 0;
+  int iDigits;
+
+  switch (*pc) {
+  case 'a': putc('\a', fp); break;
+  case 'b': putc('\b', fp); break;
+  case 'e': putc('\033', fp); break;
+  case 'f': putc('\f', fp); break;
+  case 'n': putc('\n', fp); break;
+  case 'r': putc('\r', fp); break;
+  case 't': putc('\t', fp); break;
+  case 'v': putc('\v', fp); break;
+  case '\\': putc('\\', fp); break;
+  case 'c':
+    *ppc = pc + 1;
+    return TRUE;
+  case 'x':
+    for (iDigits = 0; iDigits < 2 && isxdigit((unsigned char)pc[1]);
+         iDigits++) {
+      pc++;
+      iValue = iValue * 16 +
+        (isdigit((unsigned char)*pc) ? *pc - '0' : (*pc | 0x20) - 'a' + 10);
+    }
+    if (iDigits == 0) {
+      putc('\\', fp);
+      putc('x', fp);
+    } else
+      putc(iValue, fp);
+    break;
+  default:
+    if (*pc >= '0' && *pc <= '7') {
+      if (iEchoStyle && *pc == '0')
+        pc++;
+      for (iDigits = 0; iDigits < 3 && *pc >= '0' && *pc <= '7'; iDigits++)
+        iValue = iValue * 8 + (*pc++ - '0');
+      putc(iValue, fp);
+      *ppc = pc;
+      return FALSE;
+    }
+    /* not an escape: the backslash stands for itself */
+    putc('\\', fp);
+    if (*pc == '\0') {
+      *ppc = pc;
+      return FALSE;
+    }
+    putc(*pc, fp);
+    break;
+  }
+  *ppc = pc + 1;
+  return FALSE;
+}
+
+static int
+runEcho(int argc, char *argv[]) {
+  /* echo [-neE] [STRING]...: -n omits the newline, -e interprets
+     backslash escapes and -E, the default, does not. */
+  int iNewline = TRUE, iEscapes = FALSE;
+  const char *pc;
+  int i, j;
+
+  for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+    if (argv[i][strspn(argv[i] + 1, "neE") + 1] != '\0')
+      break;
+    for (j = 1; argv[i][j] != '\0'; j++) {
+      if (argv[i][j] == 'n')
+        iNewline = FALSE;
+      else
+        iEscapes = (argv[i][j] == 'e');
+    }
+  }
+
+  for (; i < argc; i++) {
+    for (pc = argv[i]; *pc != '\0'; ) {
+      if (iEscapes && *pc == '\\') {
+        if (putEscape(stdout, &pc, TRUE))
+          return finishOutput("echo");
+      } else
+        putchar(*pc++);
+    }
+    if (i < argc - 1)
+      putchar(' ');
+  }
+  if (iNewline)
+    putchar('\n');
+  return finishOutput("echo");
+}
+
+static int
+runTrue(int argc, char *argv[]) {
+  (void)argc;
+  (void)argv;
+  return EXIT_SUCCESS;
+}
+
+static int
+runFalse(int argc, char *argv[]) {
+  (void)argc;
+  (void)argv;
+  return EXIT_FAILURE;
+}
+
+static int
+runPwd(int argc, char *argv[]) {
+  char *pcDir;
+
+  (void)argc;
+  (void)argv;
+  pcDir = getcwd(NULL, 0);
+  if (pcDir == NULL) {
+    errorPrint(strerror(errno), FPRINTF);
+    return EXIT_FAILURE;
+  }
+  puts(pcDir);
+  free(pcDir);
+  return finishOutput("pwd");
+}
+
+/*--------------------------------------------------------------------*/
+/* printf */
+
+/* The longest conversion specification printf passes on to the C
+   library, such as "%-+#0123.456jd". */
+enum {MAX_SPEC_SIZE = 64};
+
+static int
+printfNumber(const char *pcArg, int iUnsigned, intmax_t *piValue,
+    uintmax_t *puValue) {
+  /* Convert argument pcArg of a numeric conversion.  A leading quote
+     gives the code of the character after it, and an empty argument
+     is zero.  Return FALSE after reporting the error if pcArg is not
+     entirely a number. */
+  char acMessage[MAX_MESSAGE_SIZE];
+  char *pcEnd;
+
+  *piValue = 0;
+  *puValue = 0;
+  if (pcArg[0] == '\0')
+    return TRUE;
+  if (pcArg[0] == '\'' || pcArg[0] == '\"') {
+    *piValue = (unsigned char)pcArg[1];
+    *puValue = (unsigned char)pcArg[1];
+    return TRUE;
+  }
+  errno = 0;
+  if (iUnsigned && pcArg[strspn(pcArg, " \t")] != '-')
+    *puValue = strtoumax(pcArg, &pcEnd, 0);
+  else {
+    *piValue = strtoimax(pcArg, &pcEnd, 0);
+    *puValue = (uintmax_t)*piValue;
+  }
+  if (pcEnd == pcArg || *pcEnd != '\0' || errno != 0) {
+    snprintf(acMessage, sizeof(acMessage),
+             "printf: '%s': expected a numeric value", pcArg);
+    errorPrint(acMessage, FPRINTF);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static int
+printfFloat(const char *pcArg, double *pdValue) {
+  /* Convert argument pcArg of a floating point conversion as
+     printfNumber() does. */
+  char acMessage[MAX_MESSAGE_SIZE];
+  char *pcEnd;
+
+  *pdValue = 0;
+  if (pcArg[0] == '\0')
+    return TRUE;
+  if (pcArg[0] == '\'' || pcArg[0] == '\"') {
+    *pdValue = (unsigned char)pcArg[1];
+    return TRUE;
+  }
+  errno = 0;
+  *pdValue = strtod(pcArg, &pcEnd);
+  if (pcEnd == pcArg || *pcEnd != '\0' || errno != 0) {
+    snprintf(acMessage, sizeof(acMessage),
+             "printf: '%s': expected a numeric value", pcArg);
+    errorPrint(acMessage, FPRINTF);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static int
+printfOnce(const char *pcFormat, char **ppcArgs, int iArgs, int *piNext,
+    int *piStatus) {
+  /* Write pcFormat once, taking the arguments of its conversions from
+     ppcArgs[*piNext...iArgs-1] and advancing *piNext; missing
+     arguments are empty strings or zero.  Set *piStatus to
+     EXIT_FAILURE if an argument is bad.  Return TRUE if output must
+     stop, after \c or a bad format. */
+  char acSpec[MAX_SPEC_SIZE];
+  char acMessage[MAX_MESSAGE_SIZE];
+  const char *pc = pcFormat;
+  const char *pcStart;
+  const char *pcArg;
+  size_t uSpec;
+  intmax_t iValue;
+  uintmax_t uValue;
+  double dValue;
+
+  while (*pc != '\0') {
+    if (*pc == '\\') {
+      if (putEscape(stdout, &pc, FALSE))
+        return TRUE;
+      continue;
+    }
+    if (*pc != '%') {
+      putchar(*pc++);
+      continue;
+    }
+    if (pc[1] == '%') {
+      putchar('%');
+      pc += 2;
+      continue;
+    }
+
+    /* Copy the flags, width and precision into acSpec, replacing a '*'
+       with the value of the next argument. */
+    pcStart = pc;
+    uSpec = 0;
+    acSpec[uSpec++] = *pc++;
+    while (*pc != '\0' && strchr("-+ #0123456789.*", *pc) != NULL &&
+           uSpec < MAX_SPEC_SIZE - 24) {
+      if (*pc == '*') {
+        pcArg = (*piNext < iArgs) ? ppcArgs[(*piNext)++] : "0";
+        if (!printfNumber(pcArg, FALSE, &iValue, &uValue))
+          *piStatus = EXIT_FAILURE;
+        uSpec += (size_t)snprintf(acSpec + uSpec, MAX_SPEC_SIZE - uSpec,
+                                  "%d", (int)iValue);
+        pc++;
+      } else
+        acSpec[uSpec++] = *pc++;
+    }
+
+    pcArg = (*piNext < iArgs) ? ppcArgs[(*piNext)++] : NULL;
+    switch (*pc) {
+    case 'd': case 'i':
+      strcpy(acSpec + uSpec, "jd");
+      if (pcArg != NULL && !printfNumber(pcArg, FALSE, &iValue, &uValue))
+        *piStatus = EXIT_FAILURE;
+      printf(acSpec, (pcArg == NULL) ? (intmax_t)0 : iValue);
+      break;
+    case 'o': case 'u': case 'x': case 'X':
+      acSpec[uSpec] = 'j';
+      acSpec[uSpec + 1] = *pc;
+      acSpec[uSpec + 2] = '\0';
+      if (pcArg != NULL && !printfNumber(pcArg, TRUE, &iValue, &uValue))
+        *piStatus = EXIT_FAILURE;
+      printf(acSpec, (pcArg == NULL) ? (uintmax_t)0 : uValue);
+      break;
+    case 'a': case 'A': case 'e': case 'E':
+    case 'f': case 'F': case 'g': case 'G':
+      acSpec[uSpec] = *pc;
+      acSpec[uSpec + 1] = '\0';
+      dValue = 0;
+      if (pcArg != NULL && !printfFloat(pcArg, &dValue))
+        *piStatus = EXIT_FAILURE;
+      printf(acSpec, dValue);
+      break;
+    case 'c':
+      /* an empty or missing argument writes a NUL */
+      strcpy(acSpec + uSpec, "c");
+      printf(acSpec, (pcArg == NULL) ? '\0' : pcArg[0]);
+      break;
+    case 's':
+      strcpy(acSpec + uSpec, "s");
+      printf(acSpec, (pcArg == NULL) ? "" : pcArg);
+      break;
+    case 'b':
+      /* the argument with its escapes expanded, as echo -e does,
+         NULs included; like the system's printf, %b takes no flags,
+         width or precision */
+      if (uSpec == 1) {
+        while (pcArg != NULL && *pcArg != '\0') {
+          if (*pcArg != '\\')
+            putchar(*pcArg++);
+          else if (putEscape(stdout, &pcArg, TRUE))
+            return TRUE;
+        }
+        break;
+      }
+      /* FALLTHROUGH */
+    default:
+      snprintf(acMessage, sizeof(acMessage),
+               "printf: %.*s: invalid conversion specification",
+               (int)(pc - pcStart) + (*pc != '\0'), pcStart);
+      errorPrint(acMessage, FPRINTF);
+      *piStatus = EXIT_FAILURE;
+      return TRUE;
+    }
+    pc++;
+  }
+  return FALSE;
+}
+
+static int
+runPrintf(int argc, char *argv[]) {
+  /* printf FORMAT [ARGUMENT]...: the format is used again as long as
+     arguments remain and it consumes some. */
+  int iNext = 0, iBefore;
+  int iStatus = EXIT_SUCCESS;
+
+  if (argc < 2) {
+    errorPrint("printf: missing operand", FPRINTF);
+    return EXIT_FAILURE;
+  }
+  do {
+    iBefore = iNext;
+    if (printfOnce(argv[1], argv + 2, argc - 2, &iNext, &iStatus))
+      break;
+  } while (iNext < argc - 2 && iNext > iBefore);
+
+  if (finishOutput("printf") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  return iStatus;
+}
+
+/*--------------------------------------------------------------------*/
+/* test */
+
+/* The exit status of test for a true and a false expression, and for
+   a bad one. */
+enum {TEST_TRUE = 0, TEST_FALSE = 1, TEST_ERROR = 2};
+
+/* The state of the parse of a test expression. */
+struct TestParse {
+  char **ppcArgs;
+  int iArgs;
+  int iNext;
+  int iError;
+};
+
+static void
+testError(struct TestParse *psParse, const char *pcFormat, const char *pcArg) {
+  /* Report a bad expression, once. */
+  static const char acPrefix[] = "test: ";
+  char acMessage[MAX_MESSAGE_SIZE];
+
+  if (psParse->iError)
+    return;
+  psParse->iError = TRUE;
+  strcpy(acMessage, acPrefix);
+  snprintf(acMessage + sizeof(acPrefix) - 1,
+           sizeof(acMessage) - sizeof(acPrefix) + 1, pcFormat, pcArg);
+  errorPrint(acMessage, FPRINTF);
+}
+
+static int
+testInteger(struct TestParse *psParse, const char *pcArg, long long *pllValue) {
+  /* Convert pcArg, an operand of an integer comparison. */
+  char *pcEnd;
+
+  errno = 0;
+  *pllValue = strtoll(pcArg, &pcEnd, 10);
+  while (isspace((unsigned char)*pcEnd))
+    pcEnd++;
+  if (pcEnd == pcArg || *pcEnd != '\0' || errno != 0) {
+    testError(psParse, "%s: integer expression expected", pcArg);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static int
+testIsUnary(const char *pcOp) {
+  return pcOp[0] == '-' && pcOp[1] != '\0' && pcOp[2] == '\0' &&
+         strchr("bcdefghLnprsStuwxzk", pcOp[1]) != NULL;
+}
+
+static int
+testIsBinary(const char *pcOp) {
+  static const char *const apcOps[] = {
+    "=", "==", "!=", "-eq", "-ne", "-lt", "-le", "-gt", "-ge",
+    "-nt", "-ot", "-ef", "-a", "-o", NULL};
+  int i;
+
+  for (i = 0; apcOps[i] != NULL; i++)
+    if (strcmp(pcOp, apcOps[i]) == 0)
+      return TRUE;
+  return FALSE;
+}
+
+static int
+testUnary(struct TestParse *psParse, const char *pcOp, const char *pcArg) {
+  /* Return the value of unary primary pcOp pcArg. */
+  struct stat sStat;
+  long long llFd;
+
+  switch (pcOp[1]) {
+  case 'n': return pcArg[0] != '\0';
+  case 'z': return pcArg[0] == '\0';
+  case 'r': return access(pcArg, R_OK) == 0;
+  case 'w': return access(pcArg, W_OK) == 0;
+  case 'x': return access(pcArg, X_OK) == 0;
+  case 't':
+    return testInteger(psParse, pcArg, &llFd) && isatty((int)llFd);
+  case 'h': case 'L':
+    return lstat(pcArg, &sStat) == 0 && S_ISLNK(sStat.st_mode);
+  }
+
+  if (stat(pcArg, &sStat) != 0)
+    return FALSE;
+  switch (pcOp[1]) {
+  case 'b': return S_ISBLK(sStat.st_mode);
+  case 'c': return S_ISCHR(sStat.st_mode);
+  case 'd': return S_ISDIR(sStat.st_mode);
+  case 'e': return TRUE;
+  case 'f': return S_ISREG(sStat.st_mode);
+  case 'g': return (sStat.st_mode & S_ISGID) != 0;
+  case 'k': return (sStat.st_mode & S_ISVTX) != 0;
+  case 'p': return S_ISFIFO(sStat.st_mode);
+  case 's': return sStat.st_size > 0;
+  case 'S': return S_ISSOCK(sStat.st_mode);
+  case 'u': return (sStat.st_mode & S_ISUID) != 0;
+  }
+  return FALSE;
+}
+
+static int
+testBinary(struct TestParse *psParse, const char *pcLeft, const char *pcOp,
+    const char *pcRight) {
+  /* Return the value of binary primary pcLeft pcOp pcRight. */
+  struct stat sLeft, sRight;
+  long long llLeft, llRight;
+  int iLeft, iRight;
+
+  if (strcmp(pcOp, "=") == 0 || strcmp(pcOp, "==") == 0)
+    return strcmp(pcLeft, pcRight) == 0;
+  if (strcmp(pcOp, "!=") == 0)
+    return strcmp(pcLeft, pcRight) != 0;
+  if (strcmp(pcOp, "-a") == 0)
+    return pcLeft[0] != '\0' && pcRight[0] != '\0';
+  if (strcmp(pcOp, "-o") == 0)
+    return pcLeft[0] != '\0' || pcRight[0] != '\0';
+
+  if (strcmp(pcOp, "-nt") == 0 || strcmp(pcOp, "-ot") == 0 ||
+      strcmp(pcOp, "-ef") == 0) {
+    iLeft = (stat(pcLeft, &sLeft) == 0);
+    iRight = (stat(pcRight, &sRight) == 0);
+    if (pcOp[1] == 'e')
+      return iLeft && iRight && sLeft.st_dev == sRight.st_dev &&
+             sLeft.st_ino == sRight.st_ino;
+    if (pcOp[1] == 'n')
+      return iLeft && (!iRight || sLeft.st_mtime > sRight.st_mtime);
+    return iRight && (!iLeft || sLeft.st_mtime < sRight.st_mtime);
+  }
+
+  if (!testInteger(psParse, pcLeft, &llLeft) ||
+      !testInteger(psParse, pcRight, &llRight))
+    return FALSE;
+  if (strcmp(pcOp, "-eq") == 0) return llLeft == llRight;
+  if (strcmp(pcOp, "-ne") == 0) return llLeft != llRight;
+  if (strcmp(pcOp, "-lt") == 0) return llLeft < llRight;
+  if (strcmp(pcOp, "-le") == 0) return llLeft <= llRight;
+  if (strcmp(pcOp, "-gt") == 0) return llLeft > llRight;
+  return llLeft >= llRight;
+}
+
+static int testOr(struct TestParse *psParse);
+
+static const char *
+testPeek(struct TestParse *psParse, int iAhead) {
+  /* Return the argument iAhead places past the next one, or NULL. */
+  if (psParse->iNext + iAhead >= psParse->iArgs)
+    return NULL;
+  return psParse->ppcArgs[psParse->iNext + iAhead];
+}
+
+static int
+testPrimary(struct TestParse *psParse) {
+  /* primary: '(' or ')' | UNARY-OP ARG | ARG BINARY-OP ARG | ARG */
+  const char *pcArg = testPeek(psParse, 0);
+  const char *pcOp = testPeek(psParse, 1);
+  const char *pcRight = testPeek(psParse, 2);
+  int iValue;
+
+  if (pcArg == NULL) {
+    testError(psParse, "%s", "argument expected");
+    return FALSE;
+  }
+  if (pcRight != NULL && testIsBinary(pcOp) &&
+      strcmp(pcOp, "-a") != 0 && strcmp(pcOp, "-o") != 0) {
+    psParse->iNext += 3;
+    return testBinary(psParse, pcArg, pcOp, pcRight);
+  }
+  if (strcmp(pcArg, "(") == 0) {
+    psParse->iNext++;
+    iValue = testOr(psParse);
+    if (testPeek(psParse, 0) == NULL || strcmp(testPeek(psParse, 0), ")") != 0)
+      testError(psParse, "%s", "')' expected");
+    else
+      psParse->iNext++;
+    return iValue;
+  }
+  if (testIsUnary(pcArg) && pcOp != NULL) {
+    psParse->iNext += 2;
+    return testUnary(psParse, pcArg, pcOp);
+  }
+  psParse->iNext++;
+  return pcArg[0] != '\0';
+}
+
+static int
+testNot(struct TestParse *psParse) {
+  /* not: '!' not | primary */
+  if (testPeek(psParse, 0) != NULL && strcmp(testPeek(psParse, 0), "!") == 0 &&
+      testPeek(psParse, 1) != NULL) {
+    psParse->iNext++;
+    return !testNot(psParse);
+  }
+  return testPrimary(psParse);
+}
+
+static int
+testAnd(struct TestParse *psParse) {
+  /* and: not ('-a' not)* */
+  int iValue = testNot(psParse);
+
+  while (testPeek(psParse, 0) != NULL &&
+         strcmp(testPeek(psParse, 0), "-a") == 0) {
+    psParse->iNext++;
+    iValue = testNot(psParse) && iValue;
+  }
+  return iValue;
+}
+
+static int
+testOr(struct TestParse *psParse) {
+  /* or: and ('-o' and)* */
+  int iValue = testAnd(psParse);
+
+  while (testPeek(psParse, 0) != NULL &&
+         strcmp(testPeek(psParse, 0), "-o") == 0) {
+    psParse->iNext++;
+    iValue = testAnd(psParse) || iValue;
+  }
+  return iValue;
+}
+
+static int
+testArgs(struct TestParse *psParse, char **ppcArgs, int iArgs) {
+  /* Return the value of the expression ppcArgs[0...iArgs-1].  Up to
+     four arguments are read by their number, as POSIX specifies;
+     longer expressions are parsed with the usual precedence. */
+  if (iArgs == 0)
+    return FALSE;
+  if (iArgs == 1)
+    return ppcArgs[0][0] != '\0';
+  if (iArgs == 3 && testIsBinary(ppcArgs[1]))
+    return testBinary(psParse, ppcArgs[0], ppcArgs[1], ppcArgs[2]);
+  if (strcmp(ppcArgs[0], "!") == 0 && iArgs <= 4)
+    return !testArgs(psParse, ppcArgs + 1, iArgs - 1);
+  if (iArgs == 2) {
+    if (!testIsUnary(ppcArgs[0])) {
+      testError(psParse, "%s: unary operator expected", ppcArgs[0]);
+      return FALSE;
+    }
+    return testUnary(psParse, ppcArgs[0], ppcArgs[1]);
+  }
+  if ((iArgs == 3 || iArgs == 4) && strcmp(ppcArgs[0], "(") == 0 &&
+      strcmp(ppcArgs[iArgs - 1], ")") == 0)
+    return testArgs(psParse, ppcArgs + 1, iArgs - 2);
+
+  psParse->ppcArgs = ppcArgs;
+  psParse->iArgs = iArgs;
+  psParse->iNext = 0;
+  return testOr(psParse);
+}
+
+static int
+runTest(int argc, char *argv[]) {
+  /* test EXPRESSION: exit 0 if it is true, 1 if it is false and 2 if
+     it is malformed. */
+  struct TestParse sParse = {NULL, 0, 0, FALSE};
+  int iValue;
+
+  iValue = testArgs(&sParse, argv + 1, argc - 1);
+  if (!sParse.iError && sParse.ppcArgs != NULL &&
+      sParse.iNext < sParse.iArgs)
+    testError(&sParse, "%s: unexpected argument", sParse.ppcArgs[sParse.iNext]);
+  if (sParse.iError)
+    return TEST_ERROR;
+  return iValue ? TEST_TRUE : TEST_FALSE;
+}
+
+/*--------------------------------------------------------------------*/
+/* The registry is a perfect hash table in the manner of gperf: a name
+   of length n hashes to n plus the association values of its first,
+   second and last bytes, and no two builtins share a slot, so a lookup
+   is one hash and one memcmp().  To add a builtin, write its handler
+   above and its entry at the slot its name hashes to.  If that slot is
+   taken, choose new association values (gperf -k1,2,$ over the names
+   does it); Builtin_init() checks the table in debug builds. */
+
+enum {MIN_WORD_LENGTH = 2, MAX_WORD_LENGTH = 8, MAX_HASH_VALUE = 21};
+
+static const unsigned char aucAsso[256] = {
+  ['a'] = 0, ['c'] = 8, ['d'] = 5, ['e'] = 0, ['f'] = 6, ['g'] = 0,
+  ['h'] = 1, ['l'] = 8, ['n'] = 3, ['o'] = 7, ['p'] = 5, ['r'] = 0,
+  ['s'] = 3, ['t'] = 5, ['u'] = 3, ['v'] = 4, ['w'] = 8, ['x'] = 6,
+};
+
+#define BUILTIN(name, run, flags, usage) \
+  {name, sizeof(name) - 1, run, flags, usage}
+
+static const struct Builtin asBuiltins[MAX_HASH_VALUE + 1] = {
+  [6] = BUILTIN("hash", runHash, BUILTIN_PARENT, "hash takes command names"),
+  [7] = BUILTIN("rehash", runRehash, BUILTIN_PARENT,
+                "rehash takes no parameters"),
+  [8] = BUILTIN("fg", runFg, BUILTIN_PARENT, "fg takes no parameters"),
+  [9] = BUILTIN("true", runTrue, BUILTIN_PIPELINE, NULL),
+  [11] = BUILTIN("false", runFalse, BUILTIN_PIPELINE, NULL),
+  [13] = BUILTIN("setenv", runSetenv, BUILTIN_PARENT,
+                 "setenv takes one or two parameters"),
+  [14] = BUILTIN("test", runTest, BUILTIN_PIPELINE, NULL),
+  [15] = BUILTIN("exit", runExit, BUILTIN_PARENT, "exit takes no parameters"),
+  [17] = BUILTIN("printf", runPrintf, BUILTIN_PIPELINE, NULL),
+  [18] = BUILTIN("unsetenv", runUnsetenv, BUILTIN_PARENT,
+                 "unsetenv takes one parameter"),
+  [19] = BUILTIN("echo", runEcho, BUILTIN_PIPELINE, NULL),
+  [20] = BUILTIN("cd", runCd, BUILTIN_PARENT, "cd takes one parameter"),
+  [21] = BUILTIN("pwd", runPwd, BUILTIN_PIPELINE, NULL),
+};
+
+static unsigned int
+builtinHash(const char *pc, size_t uLength) {
+  return (unsigned int)uLength + aucAsso[(unsigned char)pc[0]] +
+    aucAsso[(unsigned char)pc[1]] + aucAsso[(unsigned char)pc[uLength - 1]];
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+Builtin_init(void) {
+
+  /* Add the builtin names to the symbol table, so the tokens made from
+     now on carry their ids.  Call before the first line is lexed.
+     Return FALSE if insufficient memory is available. */
+
+  int i;
+
+  for (i = 0; i <= MAX_HASH_VALUE; i++) {
+    if (asBuiltins[i].pcName == NULL)
+      continue;
+    assert(builtinHash(asBuiltins[i].pcName, asBuiltins[i].uLength) ==
+           (unsigned int)i);
+    if (Symbol_intern(asBuiltins[i].pcName) == SYMBOL_NONE)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/*--------------------------------------------------------------------*/
+
+const struct Builtin *
+Builtin_lookup(const char *pcName, size_t uLength) {
+
+  /* Return the builtin named by the uLength bytes at pcName, or NULL
+     if there is none. */
+
+  const struct Builtin *psBuiltin;
+  unsigned int uHash;
+
+  assert(pcName != NULL);
+
+  if ((uLength < MIN_WORD_LENGTH) || (uLength > MAX_WORD_LENGTH))
+    return NULL;
+  uHash = builtinHash(pcName, uLength);
+  if (uHash > MAX_HASH_VALUE)
+    return NULL;
+  psBuiltin = &asBuiltins[uHash];
+  if ((psBuiltin->uLength != uLength) ||
+      (memcmp(psBuiltin->pcName, pcName, uLength) != 0))
+    return NULL;
+  return psBuiltin;
+}
+
+/*--------------------------------------------------------------------*/
+
+const struct Builtin *
+Builtin_ofToken(const struct Token *psToken) {
+
+  /* Return the builtin that WORD token psToken names, or NULL if it
+     names none.  Every builtin name is interned by Builtin_init(), so
+     a word without a symbol id is rejected without hashing it. */
+
+  assert(psToken != NULL);
+  assert(psToken->pcValue != NULL);
+
+  if (psToken->iSymbol == SYMBOL_NONE)
+    return NULL;
+  return Builtin_lookup(psToken->pcValue, (size_t)psToken->iLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+const struct Builtin *
+Builtin_ofSymbol(int iSymbol) {
+
+  /* Return the builtin whose name has symbol id iSymbol, or NULL if
+     there is none.  As with Builtin_ofToken(), a word without an id is
+     rejected without hashing it. */
+
+  const char *pcName;
+
+  if (iSymbol == SYMBOL_NONE)
+    return NULL;
+  pcName = Symbol_name(iSymbol);
+  return Builtin_lookup(pcName, strlen(pcName));
+}
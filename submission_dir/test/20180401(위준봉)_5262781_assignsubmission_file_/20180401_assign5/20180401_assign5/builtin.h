@@ -0,0 +1,42 @@
+#ifndef _BUILTIN_H_
+#define _BUILTIN_H_
+
+#include <stddef.h>
+#include "token.h"
+
+/* What a builtin needs from the shell. */
+enum {
+  /* It changes the state of the shell itself, so it must run in the
+     shell process. */
+  BUILTIN_PARENT = 0x01,
+
+  /* It may run as a stage of a pipeline, in a child process. */
+  BUILTIN_PIPELINE = 0x02
+};
+
+/* A builtin command.  Each one is a single entry in the registry in
+   builtin.c, next to its handler. */
+struct Builtin {
+  /* The name, and its length. */
+  const char *pcName;
+  size_t uLength;
+
+  /* Run the builtin with the argument vector of its stage, argv[0]
+     being the name, and return its exit status. */
+  int (*pfRun)(int argc, char *argv[]);
+
+  /* BUILTIN_ flags. */
+  unsigned int uFlags;
+
+  /* For a BUILTIN_PARENT builtin, the message it fails with when its
+     parameters are wrong, such as "cd takes one parameter"; NULL for
+     the others. */
+  const char *pcUsage;
+};
+
+int Builtin_init(void);
+const struct Builtin *Builtin_lookup(const char *pcName, size_t uLength);
+const struct Builtin *Builtin_ofToken(const struct Token *psToken);
+const struct Builtin *Builtin_ofSymbol(int iSymbol);
+
+#endif /* _BUILTIN_H_ */
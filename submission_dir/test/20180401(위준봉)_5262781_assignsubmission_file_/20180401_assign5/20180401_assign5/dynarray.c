@@ -6,28 +6,19 @@
 #include "dynarray.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 enum {MIN_PHYS_LENGTH = 2};
 enum {GROWTH_FACTOR = 2};
 
-/*--------------------------------------------------------------------*/
-
-/* A DynArray consists of an array, along with its logical and
-   physical lengths. */
-
-struct DynArray
-{
-  /* The number of elements in the DynArray from the client's
-     point of view. */
-  int iLength;
+/* DynArray_sort() finishes ranges of at most INSERTION_LENGTH elements
+   with insertion sort. */
+enum {INSERTION_LENGTH = 16};
 
-  /* The number of elements in the array that underlies the
-     DynArray. */
-  int iPhysLength;
+/*--------------------------------------------------------------------*/
 
-  /* The array that underlies the DynArray. */
-  const void **ppvArray;
-};
+/* struct DynArray is defined in dynarray.h, so that DynArray_size()
+   and DynArray_data() can be inlined. */
 
 /*--------------------------------------------------------------------*/
 
@@ -40,14 +31,52 @@ static int DynArray_isValid(DynArray_T oDynArray)
 {
   if (oDynArray->iLength < 0) return 0;
   if (oDynArray->iPhysLength < MIN_PHYS_LENGTH) return 0;
-  if (oDynArray->iLength > oDynArray->iPhysLength) return 0;
+  if (oDynArray->iLength + oDynArray->iSpare > oDynArray->iPhysLength)
+    return 0;
   if (oDynArray->ppvArray == NULL) return 0;
+  if (oDynArray->iSpare &&
+      (oDynArray->ppvArray[oDynArray->iLength] != NULL)) return 0;
   return 1;
 }
 #endif
 
 /*--------------------------------------------------------------------*/
 
+static int DynArray_setPhysLength(DynArray_T oDynArray,
+    int iPhysLength)
+
+  /* Give oDynArray a zeroed array of at least iPhysLength elements,
+     using the inline array if it is big enough.  Return 0 (FALSE) if
+     insufficient memory is available. */
+
+{
+  if (iPhysLength < MIN_PHYS_LENGTH)
+    iPhysLength = MIN_PHYS_LENGTH;
+
+  if (iPhysLength <= DYNARRAY_INLINE_LENGTH)
+  {
+    oDynArray->iPhysLength = DYNARRAY_INLINE_LENGTH;
+    oDynArray->ppvArray = oDynArray->apvInline;
+  }
+  else
+  {
+    oDynArray->iPhysLength = iPhysLength;
+    if (oDynArray->oArena != NULL)
+      oDynArray->ppvArray = (const void**)Arena_alloc(oDynArray->oArena,
+          sizeof(void*) * (size_t)iPhysLength);
+    else
+      oDynArray->ppvArray = (const void**)malloc(
+          sizeof(void*) * (size_t)iPhysLength);
+    if (oDynArray->ppvArray == NULL)
+      return 0;
+  }
+  memset(oDynArray->ppvArray, 0,
+      sizeof(void*) * (size_t)oDynArray->iPhysLength);
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
 DynArray_T DynArray_new(int iLength)
 
   /* Return a new DynArray_T whose length is iLength.
@@ -61,14 +90,64 @@ DynArray_T DynArray_new(int iLength)
   oDynArray = (struct DynArray*)malloc(sizeof(struct DynArray));
   assert(oDynArray != NULL);
   oDynArray->iLength = iLength;
-  if (iLength > MIN_PHYS_LENGTH)
-    oDynArray->iPhysLength = iLength;
-  else
-    oDynArray->iPhysLength = MIN_PHYS_LENGTH;
-  oDynArray->ppvArray =
-    (const void**)calloc((size_t)oDynArray->iPhysLength,
-        sizeof(void*));
-  assert(oDynArray->ppvArray != NULL);
+  oDynArray->oArena = NULL;
+  oDynArray->eGrowth = DYNARRAY_GROW_DOUBLE;
+  oDynArray->iStep = 0;
+  oDynArray->iSpare = 0;
+  if (! DynArray_setPhysLength(oDynArray, iLength))
+    assert(0 && "Cannot allocate memory");
+
+  return oDynArray;
+}
+
+/*--------------------------------------------------------------------*/
+
+DynArray_T DynArray_newWithCapacity(int iCapacity)
+
+  /* Return a new, empty DynArray_T that can hold iCapacity elements
+     before it must grow.
+     It is a checked runtime error for iCapacity to be negative. */
+
+{
+  DynArray_T oDynArray;
+
+  assert(iCapacity >= 0);
+
+  oDynArray = DynArray_new(0);
+  if ((iCapacity > oDynArray->iPhysLength) &&
+      ! DynArray_setPhysLength(oDynArray, iCapacity))
+    assert(0 && "Cannot allocate memory");
+
+  return oDynArray;
+}
+
+/*--------------------------------------------------------------------*/
+
+DynArray_T DynArray_newIn(Arena_T oArena, int iLength)
+
+  /* Return a new DynArray_T whose length is iLength, allocated from
+     oArena, or NULL if insufficient memory is available.  Freeing
+     oArena frees it; DynArray_free() does nothing to it.
+     It is a checked runtime error for oArena to be NULL or for iLength
+     to be negative. */
+
+{
+  DynArray_T oDynArray;
+
+  assert(oArena != NULL);
+  assert(iLength >= 0);
+
+  oDynArray = (struct DynArray*)Arena_alloc(oArena,
+      sizeof(struct DynArray));
+  if (oDynArray == NULL)
+    return NULL;
+  oDynArray->iLength = iLength;
+  oDynArray->oArena = oArena;
+  oDynArray->eGrowth = DYNARRAY_GROW_DOUBLE;
+  oDynArray->iStep = 0;
+  oDynArray->iSpare = 0;
+  if (! DynArray_setPhysLength(oDynArray, iLength))
+    return NULL;
 
   return oDynArray;
 }
@@ -80,10 +159,11 @@ void DynArray_free(DynArray_T oDynArray)
   /* Free oDynArray. */
 
 {
-  if (oDynArray == NULL)
+  if ((oDynArray == NULL) || (oDynArray->oArena != NULL))
     return;
 
-  free(oDynArray->ppvArray);
+  if (oDynArray->ppvArray != oDynArray->apvInline)
+    free(oDynArray->ppvArray);
   free(oDynArray);
 }
 
@@ -145,19 +225,107 @@ void *DynArray_set(DynArray_T oDynArray, int iIndex,
 
 /*--------------------------------------------------------------------*/
 
-static void DynArray_grow(DynArray_T oDynArray)
+static void DynArray_terminate(DynArray_T oDynArray)
+
+  /* Store NULL in the spare slot after the last element of oDynArray,
+     if it keeps one. */
+
+{
+  if (oDynArray->iSpare)
+    oDynArray->ppvArray[oDynArray->iLength] = NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int DynArray_resize(DynArray_T oDynArray, int iPhysLength)
 
-  /* Double the physical length of oDynArray. */
+  /* Move the elements of oDynArray to an array of iPhysLength
+     elements, or to the inline array if they fit in it.  Return 0
+     (FALSE) if insufficient memory is available, in which case
+     oDynArray is unchanged. */
 
 {
+  const void **ppvArray;
+  int iInline = (oDynArray->ppvArray == oDynArray->apvInline);
+
+  assert(iPhysLength >= oDynArray->iLength + oDynArray->iSpare);
+
+  if (iPhysLength <= DYNARRAY_INLINE_LENGTH)
+  {
+    if (! iInline)
+    {
+      memcpy(oDynArray->apvInline, oDynArray->ppvArray,
+          sizeof(void*) * (size_t)oDynArray->iLength);
+      if (oDynArray->oArena == NULL)
+        free(oDynArray->ppvArray);
+      oDynArray->ppvArray = oDynArray->apvInline;
+    }
+    oDynArray->iPhysLength = DYNARRAY_INLINE_LENGTH;
+    DynArray_terminate(oDynArray);
+    return 1;
+  }
+
+  if (iInline)
+  {
+    if (oDynArray->oArena != NULL)
+      ppvArray = (const void**)Arena_alloc(oDynArray->oArena,
+          sizeof(void*) * (size_t)iPhysLength);
+    else
+      ppvArray = (const void**)malloc(sizeof(void*) * (size_t)iPhysLength);
+    if (ppvArray == NULL)
+      return 0;
+    memcpy(ppvArray, oDynArray->apvInline,
+        sizeof(void*) * (size_t)oDynArray->iLength);
+  }
+  else if (oDynArray->oArena != NULL)
+    ppvArray = (const void**)Arena_grow(oDynArray->oArena,
+        oDynArray->ppvArray,
+        sizeof(void*) * (size_t)oDynArray->iPhysLength,
+        sizeof(void*) * (size_t)iPhysLength);
+  else
+    ppvArray = (const void**)realloc(oDynArray->ppvArray,
+        sizeof(void*) * (size_t)iPhysLength);
+  if (ppvArray == NULL)
+    return 0;
+
+  oDynArray->ppvArray = ppvArray;
+  oDynArray->iPhysLength = iPhysLength;
+  DynArray_terminate(oDynArray);
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int DynArray_grow(DynArray_T oDynArray, int iMinPhysLength)
+
+  /* Grow the physical length of oDynArray, as its growth policy says,
+     until it is at least iMinPhysLength.  Return 0 (FALSE) if
+     insufficient memory is available. */
+
+{
+  int iPhysLength;
+
   assert(oDynArray != NULL);
   assert(DynArray_isValid(oDynArray));
 
-  oDynArray->iPhysLength *= GROWTH_FACTOR;
-  oDynArray->ppvArray =
-    (const void**)realloc(oDynArray->ppvArray,
-        sizeof(void*) * oDynArray->iPhysLength);
-  assert(oDynArray->ppvArray != NULL);
+  iPhysLength = oDynArray->iPhysLength;
+  while (iPhysLength < iMinPhysLength)
+  {
+    switch (oDynArray->eGrowth)
+    {
+      case DYNARRAY_GROW_HALF:
+        iPhysLength += iPhysLength / 2;
+        break;
+      case DYNARRAY_GROW_STEP:
+        iPhysLength += oDynArray->iStep;
+        break;
+      case DYNARRAY_GROW_DOUBLE:
+      default:
+        iPhysLength *= GROWTH_FACTOR;
+        break;
+    }
+  }
+  return DynArray_resize(oDynArray, iPhysLength);
 }
 
 /*--------------------------------------------------------------------*/
@@ -171,11 +339,14 @@ int DynArray_add(DynArray_T oDynArray, const void *pvElement)
   assert(oDynArray != NULL);
   assert(DynArray_isValid(oDynArray));
 
-  if (oDynArray->iLength == oDynArray->iPhysLength)
-    DynArray_grow(oDynArray);
+  if (oDynArray->iLength + oDynArray->iSpare == oDynArray->iPhysLength)
+    if (! DynArray_grow(oDynArray,
+                        oDynArray->iLength + 1 + oDynArray->iSpare))
+      assert(0 && "Cannot allocate memory");
 
   oDynArray->ppvArray[oDynArray->iLength] = pvElement;
   oDynArray->iLength++;
+  DynArray_terminate(oDynArray);
   return 1;
 }
 
@@ -197,14 +368,169 @@ void DynArray_addAt(DynArray_T oDynArray, int iIndex,
   assert(iIndex >= 0);
   assert(iIndex <= oDynArray->iLength);
 
-  if (oDynArray->iLength == oDynArray->iPhysLength)
-    DynArray_grow(oDynArray);
+  if (oDynArray->iLength + oDynArray->iSpare == oDynArray->iPhysLength)
+    if (! DynArray_grow(oDynArray,
+                        oDynArray->iLength + 1 + oDynArray->iSpare))
+      assert(0 && "Cannot allocate memory");
 
   for (i = oDynArray->iLength; i > iIndex; i--)
     oDynArray->ppvArray[i] = oDynArray->ppvArray[i-1];
 
   oDynArray->ppvArray[iIndex] = pvElement;
   oDynArray->iLength++;
+  DynArray_terminate(oDynArray);
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynArray_addArray(DynArray_T oDynArray, void **ppvElements, int n)
+
+  /* Add the n elements at ppvElements to the end of oDynArray, growing
+     it at most once.  Return 0 (FALSE) if insufficient memory is
+     available, in which case oDynArray is unchanged.  ppvElements must
+     not point into oDynArray.
+     It is a checked runtime error for oDynArray to be NULL, for n to
+     be negative, or for ppvElements to be NULL when n is positive. */
+
+{
+  assert(oDynArray != NULL);
+  assert(DynArray_isValid(oDynArray));
+  assert(n >= 0);
+  assert((ppvElements != NULL) || (n == 0));
+
+  if (oDynArray->iLength + n + oDynArray->iSpare > oDynArray->iPhysLength)
+    if (! DynArray_grow(oDynArray,
+                        oDynArray->iLength + n + oDynArray->iSpare))
+      return 0;
+
+  if (n > 0)
+    memcpy(oDynArray->ppvArray + oDynArray->iLength, ppvElements,
+        sizeof(void*) * (size_t)n);
+  oDynArray->iLength += n;
+  DynArray_terminate(oDynArray);
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynArray_addAll(DynArray_T oDynArray, DynArray_T oFrom)
+
+  /* Add the elements of oFrom, in order, to the end of oDynArray,
+     growing it at most once.  oFrom may be oDynArray.  Return 0 (FALSE)
+     if insufficient memory is available, in which case oDynArray is
+     unchanged.
+     It is a checked runtime error for oDynArray or oFrom to be NULL. */
+
+{
+  int n;
+
+  assert(oDynArray != NULL);
+  assert(DynArray_isValid(oDynArray));
+  assert(oFrom != NULL);
+  assert(DynArray_isValid(oFrom));
+
+  n = oFrom->iLength;
+  if (oDynArray->iLength + n + oDynArray->iSpare > oDynArray->iPhysLength)
+    if (! DynArray_grow(oDynArray,
+                        oDynArray->iLength + n + oDynArray->iSpare))
+      return 0;
+
+  /* Read oFrom->ppvArray only now: growing oDynArray may have moved it
+     if the two are the same. */
+  if (n > 0)
+    memcpy(oDynArray->ppvArray + oDynArray->iLength, oFrom->ppvArray,
+        sizeof(void*) * (size_t)n);
+  oDynArray->iLength += n;
+  DynArray_terminate(oDynArray);
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynArray_reserve(DynArray_T oDynArray, int iCapacity)
+
+  /* Make oDynArray able to hold iCapacity elements before it must grow
+     again.  Return 0 (FALSE) if insufficient memory is available.
+     It is a checked runtime error for oDynArray to be NULL or for
+     iCapacity to be negative. */
+
+{
+  assert(oDynArray != NULL);
+  assert(DynArray_isValid(oDynArray));
+  assert(iCapacity >= 0);
+
+  if (iCapacity + oDynArray->iSpare <= oDynArray->iPhysLength)
+    return 1;
+  return DynArray_resize(oDynArray, iCapacity + oDynArray->iSpare);
+}
+
+/*--------------------------------------------------------------------*/
+
+void DynArray_shrinkToFit(DynArray_T oDynArray)
+
+  /* Give back the memory oDynArray holds beyond its length.  The
+     elements move to the inline array if they fit.  An array from an
+     arena only moves; the arena keeps the memory.
+     It is a checked runtime error for oDynArray to be NULL. */
+
+{
+  int iPhysLength;
+
+  assert(oDynArray != NULL);
+  assert(DynArray_isValid(oDynArray));
+
+  if (oDynArray->ppvArray == oDynArray->apvInline)
+    return;
+
+  iPhysLength = oDynArray->iLength + oDynArray->iSpare;
+  if (iPhysLength < MIN_PHYS_LENGTH)
+    iPhysLength = MIN_PHYS_LENGTH;
+  if ((iPhysLength <= DYNARRAY_INLINE_LENGTH) ||
+      (oDynArray->oArena == NULL))
+    /* A failed realloc() leaves the array as it was, which is fine. */
+    (void)DynArray_resize(oDynArray, iPhysLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+void DynArray_setGrowth(DynArray_T oDynArray,
+    enum DynArrayGrowth eGrowth, int iStep)
+
+  /* Make oDynArray grow as eGrowth says when it is full: doubling, by
+     half its size, or by iStep elements for DYNARRAY_GROW_STEP.
+     It is a checked runtime error for oDynArray to be NULL, or for
+     iStep not to be positive with DYNARRAY_GROW_STEP. */
+
+{
+  assert(oDynArray != NULL);
+  assert(DynArray_isValid(oDynArray));
+  assert((eGrowth != DYNARRAY_GROW_STEP) || (iStep > 0));
+
+  oDynArray->eGrowth = eGrowth;
+  oDynArray->iStep = iStep;
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynArray_setNullTerminated(DynArray_T oDynArray)
+
+  /* Make oDynArray keep a NULL slot after its last element from now
+     on, so that DynArray_asArgv() can hand out its array.  Return 0
+     (FALSE) if insufficient memory is available.
+     It is a checked runtime error for oDynArray to be NULL. */
+
+{
+  assert(oDynArray != NULL);
+  assert(DynArray_isValid(oDynArray));
+
+  if (oDynArray->iSpare)
+    return 1;
+  if (oDynArray->iLength == oDynArray->iPhysLength)
+    if (! DynArray_grow(oDynArray, oDynArray->iLength + 1))
+      return 0;
+  oDynArray->iSpare = 1;
+  DynArray_terminate(oDynArray);
+  return 1;
 }
 
 /*--------------------------------------------------------------------*/
@@ -231,6 +557,7 @@ void *DynArray_removeAt(DynArray_T oDynArray, int iIndex)
 
   for (i = iIndex; i < oDynArray->iLength; i++)
     oDynArray->ppvArray[i] = oDynArray->ppvArray[i+1];
+  DynArray_terminate(oDynArray);
 
   return (void*)pvOldElement;
 }
@@ -326,24 +653,155 @@ static int DynArray_partition(const void *ppvArray[],
 
 /*--------------------------------------------------------------------*/
 
-static void DynArray_quicksort(const void *ppvArray[],
+static void DynArray_medianOfThree(const void *ppvArray[],
+    int iLeft, int iRight,
+    int (*pfCompare)(const void *pvElement1, const void *pvElement2))
+
+  /* Move the median of ppvArray[iLeft], the middle element and
+     ppvArray[iRight] to ppvArray[iRight], where DynArray_partition()
+     takes its pivot from. */
+
+{
+  int iMid = iLeft + (iRight - iLeft) / 2;
+
+  if ((*pfCompare)(ppvArray[iMid], ppvArray[iLeft]) < 0)
+    DynArray_swap(ppvArray, iMid, iLeft);
+  if ((*pfCompare)(ppvArray[iRight], ppvArray[iMid]) < 0)
+  {
+    DynArray_swap(ppvArray, iRight, iMid);
+    if ((*pfCompare)(ppvArray[iMid], ppvArray[iLeft]) < 0)
+      DynArray_swap(ppvArray, iMid, iLeft);
+  }
+  /* Now ppvArray[iLeft] <= ppvArray[iMid] <= ppvArray[iRight]. */
+  DynArray_swap(ppvArray, iMid, iRight);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void DynArray_insertionSort(const void *ppvArray[],
     int iLeft, int iRight,
     int (*pfCompare)(const void *pvElement1, const void *pvElement2))
 
   /* Sort ppvArray[iLeft...iRight] in ascending order, as determined
-     by *pfCompare. */
+     by *pfCompare, by insertion. */
 
-  /* This function is a variation of the quicksort() function shown in
-     the book "Algorithms in C" by Robert Sedgewick. */
+{
+  const void *pvElement;
+  int i;
+  int j;
+
+  for (i = iLeft + 1; i <= iRight; i++)
+  {
+    pvElement = ppvArray[i];
+    for (j = i; (j > iLeft) &&
+                ((*pfCompare)(pvElement, ppvArray[j-1]) < 0); j--)
+      ppvArray[j] = ppvArray[j-1];
+    ppvArray[j] = pvElement;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static void DynArray_siftDown(const void *ppvArray[], int iBase,
+    int iRoot, int iCount,
+    int (*pfCompare)(const void *pvElement1, const void *pvElement2))
+
+  /* Restore the max-heap order of the iCount elements at
+     ppvArray[iBase...] below the node iRoot. */
+
+{
+  int iChild;
+
+  while ((iChild = 2 * iRoot + 1) < iCount)
+  {
+    if ((iChild + 1 < iCount) &&
+        ((*pfCompare)(ppvArray[iBase + iChild],
+                      ppvArray[iBase + iChild + 1]) < 0))
+      iChild++;
+    if ((*pfCompare)(ppvArray[iBase + iRoot],
+                     ppvArray[iBase + iChild]) >= 0)
+      break;
+    DynArray_swap(ppvArray, iBase + iRoot, iBase + iChild);
+    iRoot = iChild;
+  }
+}
+
+static void DynArray_heapsort(const void *ppvArray[],
+    int iLeft, int iRight,
+    int (*pfCompare)(const void *pvElement1, const void *pvElement2))
+
+  /* Sort ppvArray[iLeft...iRight] in ascending order, as determined
+     by *pfCompare, in O(n log n) time whatever the input. */
+
+{
+  int iCount = iRight - iLeft + 1;
+  int i;
+
+  for (i = iCount / 2 - 1; i >= 0; i--)
+    DynArray_siftDown(ppvArray, iLeft, i, iCount, pfCompare);
+  for (i = iCount - 1; i > 0; i--)
+  {
+    DynArray_swap(ppvArray, iLeft, iLeft + i);
+    DynArray_siftDown(ppvArray, iLeft, 0, i, pfCompare);
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static void DynArray_introsort(const void *ppvArray[],
+    int iLeft, int iRight, int iDepth,
+    int (*pfCompare)(const void *pvElement1, const void *pvElement2))
+
+  /* Sort ppvArray[iLeft...iRight] in ascending order, as determined
+     by *pfCompare.  Quicksort with a median-of-three pivot does the
+     work; once iDepth partitions have been spent the range is
+     heapsorted, so the worst case stays O(n log n), and short ranges
+     are finished by insertion. */
 
 {
   int iMid;
-  if (iRight > iLeft)
+
+  while (iRight - iLeft + 1 > INSERTION_LENGTH)
   {
+    if (iDepth == 0)
+    {
+      DynArray_heapsort(ppvArray, iLeft, iRight, pfCompare);
+      return;
+    }
+    iDepth--;
+
+    DynArray_medianOfThree(ppvArray, iLeft, iRight, pfCompare);
     iMid = DynArray_partition(ppvArray, iLeft, iRight, pfCompare);
-    DynArray_quicksort(ppvArray, iLeft, iMid - 1, pfCompare);
-    DynArray_quicksort(ppvArray, iMid + 1, iRight, pfCompare);
+
+    /* Recurse into the smaller side, so the stack stays O(log n). */
+    if (iMid - iLeft < iRight - iMid)
+    {
+      DynArray_introsort(ppvArray, iLeft, iMid - 1, iDepth, pfCompare);
+      iLeft = iMid + 1;
+    }
+    else
+    {
+      DynArray_introsort(ppvArray, iMid + 1, iRight, iDepth, pfCompare);
+      iRight = iMid - 1;
+    }
+  }
+  DynArray_insertionSort(ppvArray, iLeft, iRight, pfCompare);
+}
+
+static int DynArray_depthLimit(int iLength)
+
+  /* Return the number of partitions introsort may spend on iLength
+     elements: twice the floor of log2(iLength). */
+
+{
+  int iDepth = 0;
+
+  while (iLength > 1)
+  {
+    iLength /= 2;
+    iDepth += 2;
   }
+  return iDepth;
 }
 
 /*--------------------------------------------------------------------*/
@@ -363,8 +821,8 @@ void DynArray_sort(DynArray_T oDynArray,
   assert(DynArray_isValid(oDynArray));
   assert(pfCompare != NULL);
 
-  DynArray_quicksort(oDynArray->ppvArray, 0, oDynArray->iLength-1,
-      pfCompare);
+  DynArray_introsort(oDynArray->ppvArray, 0, oDynArray->iLength-1,
+      DynArray_depthLimit(oDynArray->iLength), pfCompare);
 }
 
 /*--------------------------------------------------------------------*/
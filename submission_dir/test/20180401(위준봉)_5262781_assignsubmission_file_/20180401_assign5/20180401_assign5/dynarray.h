@@ -6,13 +6,76 @@
 #ifndef DYNARRAY_INCLUDED
 #define DYNARRAY_INCLUDED
 
+#include <assert.h>
+#include "arena.h"
+
 typedef struct DynArray *DynArray_T;
 /* A DynArray_T is an array whose length can expand dynamically. */
 
+/* The number of elements a DynArray holds without a separate
+   array. */
+enum {DYNARRAY_INLINE_LENGTH = 16};
+
+/* How a DynArray grows when it is full: doubling (the default), by
+   half its size, or by a fixed number of elements. */
+enum DynArrayGrowth {
+  DYNARRAY_GROW_DOUBLE,
+  DYNARRAY_GROW_HALF,
+  DYNARRAY_GROW_STEP
+};
+
+/* A DynArray consists of an array, along with its logical and
+   physical lengths.  Up to DYNARRAY_INLINE_LENGTH elements live in the
+   DynArray itself, so a short array takes a single allocation.  The
+   struct is visible only so that DynArray_size() and DynArray_data()
+   can be inlined; clients must not use its fields. */
+
+struct DynArray
+{
+  /* The number of elements in the DynArray from the client's
+     point of view. */
+  int iLength;
+
+  /* The number of elements in the array that underlies the
+     DynArray. */
+  int iPhysLength;
+
+  /* The array that underlies the DynArray: apvInline, or one that
+     was allocated separately. */
+  const void **ppvArray;
+
+  /* The array that holds the first DYNARRAY_INLINE_LENGTH
+     elements. */
+  const void *apvInline[DYNARRAY_INLINE_LENGTH];
+
+  /* The Arena_T that the DynArray and its array come from, or NULL
+     if they come from malloc(). */
+  Arena_T oArena;
+
+  /* The growth policy, and the step for DYNARRAY_GROW_STEP. */
+  enum DynArrayGrowth eGrowth;
+  int iStep;
+
+  /* 1 if ppvArray[iLength] is kept NULL, else 0. */
+  int iSpare;
+};
+
 DynArray_T DynArray_new(int iLength);
 /* Return a new DynArray_T whose length is iLength.
    It is a checked runtime error for iLength to be negative. */
 
+DynArray_T DynArray_newWithCapacity(int iCapacity);
+/* Return a new, empty DynArray_T that can hold iCapacity elements
+   before it must grow.
+   It is a checked runtime error for iCapacity to be negative. */
+
+DynArray_T DynArray_newIn(Arena_T oArena, int iLength);
+/* Return a new DynArray_T whose length is iLength, allocated from
+   oArena, or NULL if insufficient memory is available.  Freeing oArena
+   frees it; DynArray_free() does nothing to it.
+   It is a checked runtime error for oArena to be NULL or for iLength
+   to be negative. */
+
 void DynArray_free(DynArray_T oDynArray);
 /* Free oDynArray. */
 
@@ -20,6 +83,52 @@ int DynArray_getLength(DynArray_T oDynArray);
 /* Return the length of oDynArray.
    It is a checked runtime error for oDynArray to be NULL. */
 
+static inline int DynArray_size(DynArray_T oDynArray)
+/* Return the length of oDynArray, as DynArray_getLength() does, without
+   a function call.
+   It is a checked runtime error for oDynArray to be NULL. */
+{
+  assert(oDynArray != NULL);
+  assert((oDynArray->iLength >= 0) &&
+         (oDynArray->iLength <= oDynArray->iPhysLength));
+  return oDynArray->iLength;
+}
+
+static inline void **DynArray_data(DynArray_T oDynArray)
+/* Return the array that holds the elements of oDynArray in order.  It
+   stays valid until oDynArray is changed; the caller must not change
+   the elements through it.
+   It is a checked runtime error for oDynArray to be NULL. */
+{
+  assert(oDynArray != NULL);
+  assert(oDynArray->ppvArray != NULL);
+  return (void**)oDynArray->ppvArray;
+}
+
+static inline char **DynArray_asArgv(DynArray_T oDynArray)
+/* Return the array of oDynArray, whose elements must be strings, as a
+   NULL-terminated argument vector that can go straight to execvp().
+   It stays valid until oDynArray is changed.
+   It is a checked runtime error for oDynArray to be NULL or not to be
+   in the mode set by DynArray_setNullTerminated(). */
+{
+  assert(oDynArray != NULL);
+  assert(oDynArray->iSpare);
+  return (char**)oDynArray->ppvArray;
+}
+
+#define DYNARRAY_FOREACH(pvElement, oDynArray)                         \
+  for (void **DynArray_ppv_ = DynArray_data(oDynArray),                \
+            **DynArray_ppvEnd_ =                                       \
+              DynArray_ppv_ + DynArray_size(oDynArray);                \
+       (DynArray_ppv_ < DynArray_ppvEnd_) &&                           \
+         ((pvElement) = *DynArray_ppv_, 1);                            \
+       DynArray_ppv_++)
+/* Run the statement that follows once for each element of oDynArray,
+   in order, with the element assigned to the pointer variable
+   pvElement.  oDynArray is evaluated and checked once, before the
+   first element; the statement must not add or remove elements. */
+
 void *DynArray_get(DynArray_T oDynArray, int iIndex);
 /* Return the iIndex'th element of oDynArray.
    It is a checked runtime error for oDynArray to be NULL.
@@ -45,6 +154,46 @@ void DynArray_addAt(DynArray_T oDynArray, int iIndex,
    It is a checked runtime error for iIndex to be less than 0 or
    greater than the length of oDynArray. */
 
+int DynArray_addArray(DynArray_T oDynArray, void **ppvElements, int n);
+/* Add the n elements at ppvElements to the end of oDynArray, growing
+   it at most once.  Return 0 (FALSE) if insufficient memory is
+   available, in which case oDynArray is unchanged.  ppvElements must
+   not point into oDynArray.
+   It is a checked runtime error for oDynArray to be NULL, for n to be
+   negative, or for ppvElements to be NULL when n is positive. */
+
+int DynArray_addAll(DynArray_T oDynArray, DynArray_T oFrom);
+/* Add the elements of oFrom, in order, to the end of oDynArray,
+   growing it at most once.  oFrom may be oDynArray.  Return 0 (FALSE)
+   if insufficient memory is available, in which case oDynArray is
+   unchanged.
+   It is a checked runtime error for oDynArray or oFrom to be NULL. */
+
+int DynArray_reserve(DynArray_T oDynArray, int iCapacity);
+/* Make oDynArray able to hold iCapacity elements before it must grow
+   again.  Return 0 (FALSE) if insufficient memory is available.
+   It is a checked runtime error for oDynArray to be NULL or for
+   iCapacity to be negative. */
+
+void DynArray_shrinkToFit(DynArray_T oDynArray);
+/* Give back the memory oDynArray holds beyond its length.  The
+   elements move to the inline array if they fit.  An array from an
+   arena only moves; the arena keeps the memory.
+   It is a checked runtime error for oDynArray to be NULL. */
+
+void DynArray_setGrowth(DynArray_T oDynArray,
+    enum DynArrayGrowth eGrowth, int iStep);
+/* Make oDynArray grow as eGrowth says when it is full: doubling, by
+   half its size, or by iStep elements for DYNARRAY_GROW_STEP.
+   It is a checked runtime error for oDynArray to be NULL, or for
+   iStep not to be positive with DYNARRAY_GROW_STEP. */
+
+int DynArray_setNullTerminated(DynArray_T oDynArray);
+/* Make oDynArray keep a NULL slot after its last element from now on,
+   so that DynArray_asArgv() can hand out its array.  Return 0 (FALSE)
+   if insufficient memory is available.
+   It is a checked runtime error for oDynArray to be NULL. */
+
 void *DynArray_removeAt(DynArray_T oDynArray, int iIndex);
 /* Remove and return the iIndex'th element of oDynArray.
    It is a checked runtime error for oDynArray to be NULL. 
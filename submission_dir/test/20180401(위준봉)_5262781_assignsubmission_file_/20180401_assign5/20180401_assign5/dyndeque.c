@@ -0,0 +1,300 @@
+/*--------------------------------------------------------------------*/
+/* dyndeque.c                                                         */
+/*--------------------------------------------------------------------*/
+
+#include "dyndeque.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The physical length is always a power of two, so that an index
+   wraps around with a mask. */
+enum {MIN_PHYS_LENGTH = 8};
+enum {GROWTH_FACTOR = 2};
+
+/*--------------------------------------------------------------------*/
+
+/* A DynDeque consists of a circular array, the position of its front
+   element, and its logical and physical lengths. */
+
+struct DynDeque
+{
+  /* The number of elements in the DynDeque. */
+  int iLength;
+
+  /* The number of elements in the array that underlies the DynDeque,
+     a power of two. */
+  int iPhysLength;
+
+  /* The index in ppvArray of the front element. */
+  int iFront;
+
+  /* The array that underlies the DynDeque.  The elements are
+     ppvArray[iFront], ppvArray[(iFront+1) % iPhysLength], ... */
+  const void **ppvArray;
+};
+
+/*--------------------------------------------------------------------*/
+
+#ifndef NDEBUG
+static int DynDeque_isValid(DynDeque_T oDynDeque)
+
+  /* Check the invariants of oDynDeque.  Return 1 (TRUE) iff oDynDeque
+     is in a valid state. */
+
+{
+  if (oDynDeque->iLength < 0) return 0;
+  if (oDynDeque->iPhysLength < MIN_PHYS_LENGTH) return 0;
+  if ((oDynDeque->iPhysLength & (oDynDeque->iPhysLength - 1)) != 0)
+    return 0;
+  if (oDynDeque->iLength > oDynDeque->iPhysLength) return 0;
+  if ((oDynDeque->iFront < 0) ||
+      (oDynDeque->iFront >= oDynDeque->iPhysLength)) return 0;
+  if (oDynDeque->ppvArray == NULL) return 0;
+  return 1;
+}
+#endif
+
+/*--------------------------------------------------------------------*/
+
+static int DynDeque_slot(DynDeque_T oDynDeque, int iIndex)
+
+  /* Return the position in ppvArray of the iIndex'th element of
+     oDynDeque. */
+
+{
+  return (oDynDeque->iFront + iIndex) & (oDynDeque->iPhysLength - 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+static DynDeque_T DynDeque_newWithLength(int iPhysLength)
+
+  /* Return a new, empty DynDeque_T whose array has room for
+     iPhysLength elements, rounded up to a power of two, or NULL if
+     insufficient memory is available. */
+
+{
+  DynDeque_T oDynDeque;
+  int iLength = MIN_PHYS_LENGTH;
+
+  while (iLength < iPhysLength)
+    iLength *= GROWTH_FACTOR;
+
+  oDynDeque = (struct DynDeque*)malloc(sizeof(struct DynDeque));
+  if (oDynDeque == NULL)
+    return NULL;
+  oDynDeque->ppvArray =
+    (const void**)malloc(sizeof(void*) * (size_t)iLength);
+  if (oDynDeque->ppvArray == NULL)
+  {
+    free(oDynDeque);
+    return NULL;
+  }
+  oDynDeque->iLength = 0;
+  oDynDeque->iPhysLength = iLength;
+  oDynDeque->iFront = 0;
+
+  return oDynDeque;
+}
+
+/*--------------------------------------------------------------------*/
+
+DynDeque_T DynDeque_new(void)
+
+  /* Return a new, empty DynDeque_T, or NULL if insufficient memory is
+     available. */
+
+{
+  return DynDeque_newWithLength(MIN_PHYS_LENGTH);
+}
+
+/*--------------------------------------------------------------------*/
+
+DynDeque_T DynDeque_fromDynArray(DynArray_T oDynArray)
+
+  /* Return a new DynDeque_T that holds the elements of oDynArray in
+     order, or NULL if insufficient memory is available.
+     It is a checked runtime error for oDynArray to be NULL. */
+
+{
+  DynDeque_T oDynDeque;
+  int iLength;
+
+  assert(oDynArray != NULL);
+
+  iLength = DynArray_size(oDynArray);
+  oDynDeque = DynDeque_newWithLength(iLength);
+  if (oDynDeque == NULL)
+    return NULL;
+  if (iLength > 0)
+    memcpy(oDynDeque->ppvArray, DynArray_data(oDynArray),
+        sizeof(void*) * (size_t)iLength);
+  oDynDeque->iLength = iLength;
+
+  return oDynDeque;
+}
+
+/*--------------------------------------------------------------------*/
+
+void DynDeque_free(DynDeque_T oDynDeque)
+
+  /* Free oDynDeque. */
+
+{
+  if (oDynDeque == NULL)
+    return;
+
+  free(oDynDeque->ppvArray);
+  free(oDynDeque);
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynDeque_getLength(DynDeque_T oDynDeque)
+
+  /* Return the length of oDynDeque.
+     It is a checked runtime error for oDynDeque to be NULL. */
+
+{
+  assert(oDynDeque != NULL);
+  assert(DynDeque_isValid(oDynDeque));
+
+  return oDynDeque->iLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *DynDeque_get(DynDeque_T oDynDeque, int iIndex)
+
+  /* Return the iIndex'th element of oDynDeque, counting from the
+     front.
+     It is a checked runtime error for oDynDeque to be NULL.
+     It is a checked runtime error for iIndex to be less than 0 or
+     greater than or equal to the length of oDynDeque. */
+
+{
+  assert(oDynDeque != NULL);
+  assert(DynDeque_isValid(oDynDeque));
+  assert(iIndex >= 0);
+  assert(iIndex < oDynDeque->iLength);
+
+  return (void*)oDynDeque->ppvArray[DynDeque_slot(oDynDeque, iIndex)];
+}
+
+/*--------------------------------------------------------------------*/
+
+static int DynDeque_grow(DynDeque_T oDynDeque)
+
+  /* Double the physical length of oDynDeque, unwrapping its elements
+     to the start of the new array.  Return 0 (FALSE) if insufficient
+     memory is available. */
+
+{
+  const void **ppvArray;
+  int iPhysLength = oDynDeque->iPhysLength * GROWTH_FACTOR;
+  int iFirstPart;
+
+  ppvArray = (const void**)malloc(sizeof(void*) * (size_t)iPhysLength);
+  if (ppvArray == NULL)
+    return 0;
+
+  /* Copy the run from iFront to the end of the array, then the part
+     that wrapped around to its start. */
+  iFirstPart = oDynDeque->iPhysLength - oDynDeque->iFront;
+  if (iFirstPart > oDynDeque->iLength)
+    iFirstPart = oDynDeque->iLength;
+  memcpy(ppvArray, oDynDeque->ppvArray + oDynDeque->iFront,
+      sizeof(void*) * (size_t)iFirstPart);
+  memcpy(ppvArray + iFirstPart, oDynDeque->ppvArray,
+      sizeof(void*) * (size_t)(oDynDeque->iLength - iFirstPart));
+
+  free(oDynDeque->ppvArray);
+  oDynDeque->ppvArray = ppvArray;
+  oDynDeque->iPhysLength = iPhysLength;
+  oDynDeque->iFront = 0;
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynDeque_pushFront(DynDeque_T oDynDeque, const void *pvElement)
+
+  /* Add pvElement to the front of oDynDeque.  Return 0 (FALSE) if
+     insufficient memory is available.
+     It is a checked runtime error for oDynDeque to be NULL. */
+
+{
+  assert(oDynDeque != NULL);
+  assert(DynDeque_isValid(oDynDeque));
+
+  if (oDynDeque->iLength == oDynDeque->iPhysLength)
+    if (! DynDeque_grow(oDynDeque))
+      return 0;
+
+  oDynDeque->iFront = DynDeque_slot(oDynDeque, -1);
+  oDynDeque->ppvArray[oDynDeque->iFront] = pvElement;
+  oDynDeque->iLength++;
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynDeque_pushBack(DynDeque_T oDynDeque, const void *pvElement)
+
+  /* Add pvElement to the back of oDynDeque.  Return 0 (FALSE) if
+     insufficient memory is available.
+     It is a checked runtime error for oDynDeque to be NULL. */
+
+{
+  assert(oDynDeque != NULL);
+  assert(DynDeque_isValid(oDynDeque));
+
+  if (oDynDeque->iLength == oDynDeque->iPhysLength)
+    if (! DynDeque_grow(oDynDeque))
+      return 0;
+
+  oDynDeque->ppvArray[DynDeque_slot(oDynDeque, oDynDeque->iLength)] =
+    pvElement;
+  oDynDeque->iLength++;
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *DynDeque_popFront(DynDeque_T oDynDeque)
+
+  /* Remove and return the front element of oDynDeque.
+     It is a checked runtime error for oDynDeque to be NULL or
+     empty. */
+
+{
+  const void *pvElement;
+
+  assert(oDynDeque != NULL);
+  assert(DynDeque_isValid(oDynDeque));
+  assert(oDynDeque->iLength > 0);
+
+  pvElement = oDynDeque->ppvArray[oDynDeque->iFront];
+  oDynDeque->iFront = DynDeque_slot(oDynDeque, 1);
+  oDynDeque->iLength--;
+  return (void*)pvElement;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *DynDeque_popBack(DynDeque_T oDynDeque)
+
+  /* Remove and return the back element of oDynDeque.
+     It is a checked runtime error for oDynDeque to be NULL or
+     empty. */
+
+{
+  assert(oDynDeque != NULL);
+  assert(DynDeque_isValid(oDynDeque));
+  assert(oDynDeque->iLength > 0);
+
+  oDynDeque->iLength--;
+  return (void*)oDynDeque->ppvArray[DynDeque_slot(oDynDeque,
+      oDynDeque->iLength)];
+}
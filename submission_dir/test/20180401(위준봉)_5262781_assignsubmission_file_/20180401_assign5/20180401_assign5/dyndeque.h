@@ -0,0 +1,55 @@
+/*--------------------------------------------------------------------*/
+/* dyndeque.h                                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef DYNDEQUE_INCLUDED
+#define DYNDEQUE_INCLUDED
+
+#include "dynarray.h"
+
+typedef struct DynDeque *DynDeque_T;
+/* A DynDeque_T is a sequence whose length can expand dynamically and
+   that can be added to and removed from at either end in constant
+   time. */
+
+DynDeque_T DynDeque_new(void);
+/* Return a new, empty DynDeque_T, or NULL if insufficient memory is
+   available. */
+
+DynDeque_T DynDeque_fromDynArray(DynArray_T oDynArray);
+/* Return a new DynDeque_T that holds the elements of oDynArray in
+   order, or NULL if insufficient memory is available.
+   It is a checked runtime error for oDynArray to be NULL. */
+
+void DynDeque_free(DynDeque_T oDynDeque);
+/* Free oDynDeque. */
+
+int DynDeque_getLength(DynDeque_T oDynDeque);
+/* Return the length of oDynDeque.
+   It is a checked runtime error for oDynDeque to be NULL. */
+
+void *DynDeque_get(DynDeque_T oDynDeque, int iIndex);
+/* Return the iIndex'th element of oDynDeque, counting from the front.
+   It is a checked runtime error for oDynDeque to be NULL.
+   It is a checked runtime error for iIndex to be less than 0 or
+   greater than or equal to the length of oDynDeque. */
+
+int DynDeque_pushFront(DynDeque_T oDynDeque, const void *pvElement);
+/* Add pvElement to the front of oDynDeque.  Return 0 (FALSE) if
+   insufficient memory is available.
+   It is a checked runtime error for oDynDeque to be NULL. */
+
+int DynDeque_pushBack(DynDeque_T oDynDeque, const void *pvElement);
+/* Add pvElement to the back of oDynDeque.  Return 0 (FALSE) if
+   insufficient memory is available.
+   It is a checked runtime error for oDynDeque to be NULL. */
+
+void *DynDeque_popFront(DynDeque_T oDynDeque);
+/* Remove and return the front element of oDynDeque.
+   It is a checked runtime error for oDynDeque to be NULL or empty. */
+
+void *DynDeque_popBack(DynDeque_T oDynDeque);
+/* Remove and return the back element of oDynDeque.
+   It is a checked runtime error for oDynDeque to be NULL or empty. */
+
+#endif
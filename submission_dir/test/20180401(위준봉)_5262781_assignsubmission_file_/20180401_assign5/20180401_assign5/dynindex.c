@@ -0,0 +1,252 @@
+/*--------------------------------------------------------------------*/
+/* dynindex.c                                                         */
+/*--------------------------------------------------------------------*/
+
+#include "dynindex.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __GNUC__
+#define DynIndex_prefetch(pv) __builtin_prefetch(pv)
+#else
+#define DynIndex_prefetch(pv) ((void)0)
+#endif
+
+/* The number of levels below the current node whose first node is
+   prefetched: 4 levels ahead is 16 nodes, a few cache lines. */
+enum {PREFETCH_NODES = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* A Node holds one key of the index. */
+
+struct Node
+{
+  /* The first eight bytes of the key after the common prefix,
+     zero-padded, read as a big-endian number so that comparing
+     prefixes as numbers orders them as strcmp() would. */
+  uint64_t uPrefix;
+
+  /* The key, past the common prefix. */
+  const char *pcKey;
+
+  /* The key's index in the indexed DynArray_T. */
+  int iIndex;
+};
+
+/* A DynIndex consists of the keys in Eytzinger order: psNodes[1] is
+   the root and the children of psNodes[k] are psNodes[2k] and
+   psNodes[2k+1].  psNodes[0] is unused.  The bytes that all keys
+   start with, such as "/usr/bin/" in a table of paths, are compared
+   once per search instead of once per node, and the inline prefixes
+   hold the bytes that follow them. */
+
+struct DynIndex
+{
+  /* The number of keys. */
+  int iLength;
+
+  /* The common prefix: the first uCommon bytes of pcCommon, which is
+     one of the keys. */
+  const char *pcCommon;
+  size_t uCommon;
+
+  /* The nodes, psNodes[1...iLength]. */
+  struct Node *psNodes;
+};
+
+/*--------------------------------------------------------------------*/
+
+static uint64_t DynIndex_prefix(const char *pcKey)
+
+  /* Return the first eight bytes of pcKey as struct Node keeps them. */
+
+{
+  uint64_t uPrefix = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+  {
+    uPrefix <<= 8;
+    if (*pcKey != '\0')
+      uPrefix |= (unsigned char)*pcKey++;
+  }
+  return uPrefix;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int DynIndex_compare(const struct Node *psNode, uint64_t uPrefix,
+    const char *pcKey)
+
+  /* Compare the key of psNode with pcKey, whose prefix is uPrefix, as
+     strcmp() would, looking past the prefixes only if they are
+     equal. */
+
+{
+  if (psNode->uPrefix != uPrefix)
+    return (psNode->uPrefix < uPrefix) ? -1 : 1;
+
+  /* Equal prefixes with a NUL among them mean equal keys. */
+  if ((uPrefix & 0xff) == 0)
+    return 0;
+  return strcmp(psNode->pcKey + 8, pcKey + 8);
+}
+
+/*--------------------------------------------------------------------*/
+
+static const char *DynIndex_keyOf(DynArray_T oDynArray,
+    const char *(*pfGetKey)(const void *pvElement), int iIndex)
+
+  /* Return the key of the iIndex'th element of oDynArray. */
+
+{
+  const void *pvElement = DynArray_get(oDynArray, iIndex);
+
+  return (pfGetKey != NULL) ?
+    (*pfGetKey)(pvElement) : (const char*)pvElement;
+}
+
+/*--------------------------------------------------------------------*/
+
+static void DynIndex_fill(DynIndex_T oDynIndex, DynArray_T oDynArray,
+    const char *(*pfGetKey)(const void *pvElement), int *piNext, int k)
+
+  /* Fill the subtree of oDynIndex rooted at node k with the elements of
+     oDynArray from index *piNext on, in order, advancing *piNext. */
+
+{
+  struct Node *psNode;
+
+  /* An in-order walk of the implicit tree visits the nodes in sorted
+     order.  The tree is at most about 31 levels deep, so recursion is
+     fine. */
+  if (k > oDynIndex->iLength)
+    return;
+
+  DynIndex_fill(oDynIndex, oDynArray, pfGetKey, piNext, 2 * k);
+
+  psNode = &oDynIndex->psNodes[k];
+  psNode->pcKey = DynIndex_keyOf(oDynArray, pfGetKey, *piNext) +
+    oDynIndex->uCommon;
+  psNode->uPrefix = DynIndex_prefix(psNode->pcKey);
+  psNode->iIndex = (*piNext)++;
+
+  DynIndex_fill(oDynIndex, oDynArray, pfGetKey, piNext, 2 * k + 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+DynIndex_T DynIndex_new(DynArray_T oDynArray,
+    const char *(*pfGetKey)(const void *pvElement))
+
+  /* Return a new DynIndex_T over oDynArray, or NULL if insufficient
+     memory is available.  (*pfGetKey)(pvElement) returns the key of
+     element pvElement; if pfGetKey is NULL, each element is its own
+     key.
+     It is a checked runtime error for oDynArray to be NULL.
+     It is an unchecked runtime error for oDynArray not to be sorted by
+     key. */
+
+{
+  DynIndex_T oDynIndex;
+  const char *pcLast;
+  int iNext = 0;
+
+  assert(oDynArray != NULL);
+
+  oDynIndex = (struct DynIndex*)malloc(sizeof(struct DynIndex));
+  if (oDynIndex == NULL)
+    return NULL;
+  oDynIndex->iLength = DynArray_getLength(oDynArray);
+
+  /* Leave room past the last node so that prefetching beyond the
+     bottom level stays inside the allocation. */
+  oDynIndex->psNodes = (struct Node*)calloc(
+      (size_t)oDynIndex->iLength + 1 + PREFETCH_NODES,
+      sizeof(struct Node));
+  if (oDynIndex->psNodes == NULL)
+  {
+    free(oDynIndex);
+    return NULL;
+  }
+
+  /* In a sorted table, the prefix that the first and last keys share
+     is shared by all. */
+  oDynIndex->pcCommon = "";
+  oDynIndex->uCommon = 0;
+  if (oDynIndex->iLength > 0)
+  {
+    oDynIndex->pcCommon = DynIndex_keyOf(oDynArray, pfGetKey, 0);
+    pcLast = DynIndex_keyOf(oDynArray, pfGetKey, oDynIndex->iLength - 1);
+    while ((oDynIndex->pcCommon[oDynIndex->uCommon] != '\0') &&
+           (oDynIndex->pcCommon[oDynIndex->uCommon] ==
+            pcLast[oDynIndex->uCommon]))
+      oDynIndex->uCommon++;
+  }
+
+  DynIndex_fill(oDynIndex, oDynArray, pfGetKey, &iNext, 1);
+  return oDynIndex;
+}
+
+/*--------------------------------------------------------------------*/
+
+void DynIndex_free(DynIndex_T oDynIndex)
+
+  /* Free oDynIndex. */
+
+{
+  if (oDynIndex == NULL)
+    return;
+
+  free(oDynIndex->psNodes);
+  free(oDynIndex);
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynIndex_search(DynIndex_T oDynIndex, const char *pcKey)
+
+  /* Return the index in the indexed DynArray_T of an element whose key
+     is pcKey, or -1 if there is none.
+     It is a checked runtime error for oDynIndex or pcKey to be NULL. */
+
+{
+  const struct Node *psNodes;
+  uint64_t uPrefix;
+  size_t k = 1;
+  size_t n;
+
+  assert(oDynIndex != NULL);
+  assert(pcKey != NULL);
+
+  /* A key without the common prefix is in no table. */
+  if (strncmp(pcKey, oDynIndex->pcCommon, oDynIndex->uCommon) != 0)
+    return -1;
+  pcKey += oDynIndex->uCommon;
+
+  psNodes = oDynIndex->psNodes;
+  n = (size_t)oDynIndex->iLength;
+  uPrefix = DynIndex_prefix(pcKey);
+
+  /* Descend to the leaf level, going right past every key less than
+     pcKey.  The branch is turned into arithmetic. */
+  while (k <= n)
+  {
+    if (k * PREFETCH_NODES <= n + PREFETCH_NODES)
+      DynIndex_prefetch(&psNodes[k * PREFETCH_NODES]);
+    k = 2 * k + (DynIndex_compare(&psNodes[k], uPrefix, pcKey) < 0);
+  }
+
+  /* Undo the trailing right turns; k is then the first key that is
+     not less than pcKey, or 0 if there is none. */
+  while (k & 1)
+    k >>= 1;
+  k >>= 1;
+
+  if ((k == 0) || (DynIndex_compare(&psNodes[k], uPrefix, pcKey) != 0))
+    return -1;
+  return psNodes[k].iIndex;
+}
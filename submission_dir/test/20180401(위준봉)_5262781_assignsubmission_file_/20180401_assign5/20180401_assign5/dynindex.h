@@ -0,0 +1,37 @@
+/*--------------------------------------------------------------------*/
+/* dynindex.h                                                         */
+/*--------------------------------------------------------------------*/
+
+#ifndef DYNINDEX_INCLUDED
+#define DYNINDEX_INCLUDED
+
+#include "dynarray.h"
+
+typedef struct DynIndex *DynIndex_T;
+/* A DynIndex_T is a read-only search index over a DynArray_T whose
+   elements are ordered by a string key, as strcmp() orders them.  It
+   answers the same questions as DynArray_bsearch() with fewer cache
+   misses: the keys are laid out in breadth-first (Eytzinger) order,
+   each with the eight bytes after the prefix common to all keys
+   stored inline, and the probes of the next levels are prefetched. */
+
+DynIndex_T DynIndex_new(DynArray_T oDynArray,
+    const char *(*pfGetKey)(const void *pvElement));
+/* Return a new DynIndex_T over oDynArray, or NULL if insufficient
+   memory is available.  (*pfGetKey)(pvElement) returns the key of
+   element pvElement; if pfGetKey is NULL, each element is its own key.
+   The index refers to the keys, not copies of them, and does not
+   follow later changes to oDynArray.
+   It is a checked runtime error for oDynArray to be NULL.
+   It is an unchecked runtime error for oDynArray not to be sorted by
+   key. */
+
+void DynIndex_free(DynIndex_T oDynIndex);
+/* Free oDynIndex. */
+
+int DynIndex_search(DynIndex_T oDynIndex, const char *pcKey);
+/* Return the index in the indexed DynArray_T of an element whose key
+   is pcKey, or -1 if there is none.
+   It is a checked runtime error for oDynIndex or pcKey to be NULL. */
+
+#endif
@@ -0,0 +1,144 @@
+/*--------------------------------------------------------------------*/
+/* dynvec.h                                                           */
+/*--------------------------------------------------------------------*/
+
+#ifndef DYNVEC_INCLUDED
+#define DYNVEC_INCLUDED
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/* DYNARRAY_DEFINE(Name, Type) defines struct Name, an array of Type
+   elements held by value whose length can expand dynamically, and
+   static inline functions to use it:
+
+   void Name_init(struct Name *ps, Arena_T oArena);
+   Make *ps empty.  Its array comes from oArena, or from malloc() if
+   oArena is NULL.
+
+   void Name_free(struct Name *ps);
+   Free the array of *ps unless it came from an arena.
+
+   int Name_size(const struct Name *ps);
+   Type *Name_data(const struct Name *ps);
+   Type *Name_at(const struct Name *ps, int iIndex);
+   Return the length of *ps, its array, or its iIndex'th element.  It
+   is a checked runtime error for iIndex to be out of range.
+
+   int Name_reserve(struct Name *ps, int iPhysLength);
+   Make room for at least iPhysLength elements.
+
+   Type *Name_push(struct Name *ps);
+   Add an uninitialized element to the end of *ps and return it.
+
+   int Name_add(struct Name *ps, Type element);
+   int Name_addArray(struct Name *ps, const Type *pElements, int n);
+   Add element, or the n elements at pElements, to the end of *ps.
+
+   The functions that add return 0 (FALSE) or NULL if insufficient
+   memory is available, leaving *ps as it was.  Unlike a DynArray_T,
+   the struct is not opaque: a loop may index ps->pData directly. */
+
+#define DYNARRAY_DEFINE(Name, Type)                                    \
+                                                                       \
+struct Name                                                            \
+{                                                                      \
+  /* The elements, the number in use and the number allocated. */      \
+  Type *pData;                                                         \
+  int iLength;                                                         \
+  int iPhysLength;                                                     \
+                                                                       \
+  /* The arena pData comes from, or NULL for malloc(). */              \
+  Arena_T oArena;                                                      \
+};                                                                     \
+                                                                       \
+static inline void Name##_init(struct Name *ps, Arena_T oArena)        \
+{                                                                      \
+  ps->pData = NULL;                                                    \
+  ps->iLength = 0;                                                     \
+  ps->iPhysLength = 0;                                                 \
+  ps->oArena = oArena;                                                 \
+}                                                                      \
+                                                                       \
+static inline void Name##_free(struct Name *ps)                        \
+{                                                                      \
+  if (ps->oArena == NULL)                                              \
+    free(ps->pData);                                                   \
+  ps->pData = NULL;                                                    \
+  ps->iLength = 0;                                                     \
+  ps->iPhysLength = 0;                                                 \
+}                                                                      \
+                                                                       \
+static inline int Name##_size(const struct Name *ps)                   \
+{                                                                      \
+  return ps->iLength;                                                  \
+}                                                                      \
+                                                                       \
+static inline Type *Name##_data(const struct Name *ps)                 \
+{                                                                      \
+  return ps->pData;                                                    \
+}                                                                      \
+                                                                       \
+static inline Type *Name##_at(const struct Name *ps, int iIndex)       \
+{                                                                      \
+  assert((iIndex >= 0) && (iIndex < ps->iLength));                     \
+  return &ps->pData[iIndex];                                           \
+}                                                                      \
+                                                                       \
+static inline int Name##_reserve(struct Name *ps, int iPhysLength)     \
+{                                                                      \
+  Type *pData;                                                         \
+  int iNewLength;                                                      \
+                                                                       \
+  if (iPhysLength <= ps->iPhysLength)                                  \
+    return 1;                                                          \
+  iNewLength = ps->iPhysLength ? ps->iPhysLength * 2 : 16;             \
+  if (iNewLength < iPhysLength)                                        \
+    iNewLength = iPhysLength;                                          \
+  if (ps->oArena != NULL)                                              \
+    pData = (Type*)Arena_grow(ps->oArena, ps->pData,                   \
+        sizeof(Type) * (size_t)ps->iLength,                            \
+        sizeof(Type) * (size_t)iNewLength);                            \
+  else                                                                 \
+    pData = (Type*)realloc(ps->pData,                                  \
+        sizeof(Type) * (size_t)iNewLength);                            \
+  if (pData == NULL)                                                   \
+    return 0;                                                          \
+  ps->pData = pData;                                                   \
+  ps->iPhysLength = iNewLength;                                        \
+  return 1;                                                            \
+}                                                                      \
+                                                                       \
+static inline Type *Name##_push(struct Name *ps)                       \
+{                                                                      \
+  if ((ps->iLength == ps->iPhysLength) &&                              \
+      ! Name##_reserve(ps, ps->iLength + 1))                           \
+    return NULL;                                                       \
+  return &ps->pData[ps->iLength++];                                    \
+}                                                                      \
+                                                                       \
+static inline int Name##_add(struct Name *ps, Type element)            \
+{                                                                      \
+  Type *pElement = Name##_push(ps);                                    \
+                                                                       \
+  if (pElement == NULL)                                                \
+    return 0;                                                          \
+  *pElement = element;                                                 \
+  return 1;                                                            \
+}                                                                      \
+                                                                       \
+static inline int Name##_addArray(struct Name *ps,                     \
+    const Type *pElements, int n)                                      \
+{                                                                      \
+  assert(n >= 0);                                                      \
+  if (! Name##_reserve(ps, ps->iLength + n))                           \
+    return 0;                                                          \
+  if (n > 0)                                                           \
+    memcpy(ps->pData + ps->iLength, pElements, sizeof(Type) * (size_t)n); \
+  ps->iLength += n;                                                    \
+  return 1;                                                            \
+}
+
+#endif
@@ -1,20 +1,21 @@
-#include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "builtin.h"
 #include "dynarray.h"
+#include "launch.h"
 #include "lexsyn.h"
+#include "parsecache.h"
+#include "pipeline.h"
 #include "token.h"
 #include "util.h"
 
-#define FD_IN 0
-#define FD_OUT 1
-
 /*--------------------------------------------------------------------*/
 /* ish.c                                                              */
 /* Original Author: Bob Dondero                                       */
@@ -41,274 +42,207 @@ void signal_handler(int signo) {
     on_quit = 0;
 }
 
-static int do_exec(char **argv, int fd_in, int fd_out) {
-  /* fork a process and execvp
-   * @argv: argument vector
-   * @fd_in: fd to be set as stdin of the child process
-   * @fd_out: fd to be set as stdout of the child process
+static int handle_normal(const struct Pipeline *psPipeline) {
+  /* handle non built-in command
+   * @psPipeline: parsed command line
+   * return the exit status of the last stage
    */
-  int pid;
+  int *status;
+  int ret;
 
-  assert(argv != NULL && fd_in >= 0 && fd_out >= 0);
-
-#ifdef JB_DEBUG
-  if (getenv("DEBUG") != NULL) {
-    int i;
-    fprintf(stderr, "Exec: ");
-    for (i = 0; argv[i] != NULL; i++)
-      fprintf(stderr, "%s ", argv[i]);
-    fprintf(stderr, "/ fd_in: %d, fd_out: %d\n", fd_in, fd_out);
+  status = calloc(StageVec_size(&psPipeline->sStages), sizeof(int));
+  if (status == NULL) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    return EXIT_FAILURE;
   }
-#endif
+  ret = launch_pipeline(psPipeline, status);
+  free(status);
+  return ret;
+}
 
-  /* Your program should call fflush(NULL) before each call of fork to clear all
-   * I/O buffers.
+static int run_parent(const struct Builtin *psBuiltin,
+                      const struct TokenLine *psLine, int argc, char **argv) {
+  /* run a builtin that changes the shell itself, in the shell.  It
+   * cannot take part in a pipeline, a redirection or the background,
+   * so a line with any token besides its words makes it fail with its
+   * usage message instead of dropping the rest of the line
+   * @psBuiltin: the builtin
+   * @psLine: the tokens of the line
+   * @argc, @argv: the words of the first stage
+   * return its exit status
    */
-  fflush(stdout);
-  if ((pid = fork()) < 0) {
-    errorPrint(strerror(errno), FPRINTF);
-    return pid;
-  } else if (pid == 0) {
-    if (signal(SIGINT, SIG_DFL) == SIG_ERR) {
-      errorPrint(strerror(errno), FPRINTF);
-      exit(EXIT_FAILURE);
-    }
-    if (signal(SIGQUIT, SIG_DFL) == SIG_ERR) {
-      errorPrint(strerror(errno), FPRINTF);
-      exit(EXIT_FAILURE);
-    }
-    if (signal(SIGALRM, SIG_DFL) == SIG_ERR) {
-      errorPrint(strerror(errno), FPRINTF);
-      exit(EXIT_FAILURE);
-    }
-    if (fd_in != FD_IN) {
-      dup2(fd_in, FD_IN);
-      close(fd_in);
-    }
-    if (fd_out != FD_OUT) {
-      dup2(fd_out, FD_OUT);
-      close(fd_out);
-    }
-    execvp(argv[0], argv);
-    errorPrint(argv[0], SETUP);
-    errorPrint(strerror(errno), FPRINTF);
-    exit(EXIT_FAILURE);
-  } else {
-    if (fd_in != FD_IN)
-      close(fd_in);
-    if (fd_out != FD_OUT)
-      close(fd_out);
+  if (TokenVec_size(&psLine->sTokens) != argc) {
+    errorPrint((char *)psBuiltin->pcUsage, FPRINTF);
+    return EXIT_FAILURE;
   }
+  return psBuiltin->pfRun(argc, argv);
+}
 
-  return pid;
+/* A line read by readLine().  psLine and psPipeline point either at
+ * sLine and sPipeline, which the caller must free with releaseLine(),
+ * or at an entry of the parse cache. */
+struct Line {
+  struct TokenLine sLine;
+  struct Pipeline sPipeline;
+  const struct TokenLine *psLine;
+  const struct Pipeline *psPipeline;
+  enum LexResult lexcheck;
+};
+
+/* Lines are read in pieces of this many bytes, less the terminating
+ * NUL.  A line may be any length; only one that fits in a single
+ * piece is kept by the parse cache. */
+enum {LINE_CHUNK_SIZE = 1024};
+
+static int readChunk(FILE *fp, char *chunk, size_t size, size_t *len) {
+  /* read the next piece of a line with fgets()
+   * @fp: input stream
+   * @chunk: buffer of size bytes
+   * @len: receives the number of bytes read.  strlen() would stop at a
+   *   NUL byte in the input; the chunk is filled with non-NUL bytes
+   *   first instead, so the NUL fgets() stores after the input is the
+   *   last one in it.  The lexer ends the line at an input NUL.
+   * return FALSE if fp is at EOF, when chunk no longer holds what was
+   * read before
+   */
+  size_t n;
+
+  memset(chunk, '\n', size);
+  if (fgets(chunk, (int)size, fp) == NULL)
+    return FALSE;
+  for (n = size - 1; chunk[n] != '\0'; n--)
+    ;
+  *len = n;
+  return TRUE;
 }
 
-static void handle_normal(DynArray_T oTokens) {
-  /* handle non built-in command
-   * @oTokens: token array
+static int readLine(FILE *fp, struct Line *line, int echo) {
+  /* read one line of any length from fp, lexing and parsing it chunk by
+   * chunk; a line that fits in one chunk and was run before is taken
+   * from the parse cache instead
+   * @fp: input stream
+   * @line: receives the tokens, the parsed line and the lex result
+   * @echo: if set, print "% " and the line as it is read
+   * return FALSE if fp is at EOF
    */
-  struct Token *t;
-  char **argv = NULL;
-  int *pidv;
-  int argc, pidc = 1;
-  int cur_argv = 0, cur_pidv = 0;
-  int fd_in = 0, fd_out = 1;
-  int fd_pipe[2];
-  int i, j;
-  enum TokenType t_state = TOKEN_WORD;
+  char acChunk[LINE_CHUNK_SIZE];
+  char acKey[LINE_CHUNK_SIZE];
+  struct Lexer sLexer;
+  const struct CacheEntry *psEntry;
+  enum LexResult lexcheck = LEX_MORE;
+  size_t len = 0, keylen = 0;
+  int read = FALSE, newline = FALSE;
 
-  for (i = 0; i < DynArray_getLength(oTokens); i++) {
-    t = DynArray_get(oTokens, i);
-    if (t->eType == TOKEN_PIPE)
-      pidc++;
-  }
-  pidv = calloc(pidc, sizeof(int));
+  line->psLine = &line->sLine;
+  line->psPipeline = &line->sPipeline;
+  while (lexcheck == LEX_MORE) {
+    if (!readChunk(fp, acChunk, sizeof(acChunk), &len)) {
+      if (!read)
+        return FALSE;
+      lexcheck = Lexer_finish(&sLexer);
+      break;
+    }
+    newline = len > 0 && acChunk[len - 1] == '\n';
+    if (echo) {
+      if (!read)
+        fputs("% ", stdout);
+      fputs(acChunk, stdout);
+    }
 
-  for (i = 0; i < DynArray_getLength(oTokens); i++) {
-    if (argv == NULL) {
-      argc = 0;
-      for (j = i; j < DynArray_getLength(oTokens); j++) {
-        t = DynArray_get(oTokens, j);
-        if (t->pcValue == NULL) {
-          if ((t->eType == TOKEN_PIPE) || (t->eType == TOKEN_BG)) {
-            break;
-          }
-          // Redirection
-          assert(t->eType == TOKEN_REDIN || t->eType == TOKEN_REDOUT);
-          argc--;
-        } else
-          argc++;
+    /* the whole line is in the first chunk: try the cache */
+    if (!read && (len < sizeof(acChunk) - 1 || newline)) {
+      keylen = len;
+      psEntry = ParseCache_lookup(acChunk, keylen);
+      if (psEntry != NULL) {
+        if (echo)
+          fflush(stdout);
+        line->psLine = &psEntry->sLine;
+        line->psPipeline = &psEntry->sPipeline;
+        line->lexcheck = LEX_SUCCESS;
+        return TRUE;
       }
-      argv = calloc((argc + 1), sizeof(char *));
-      cur_argv = 0;
+      /* acChunk is reused below; keep the key for ParseCache_insert() */
+      memcpy(acKey, acChunk, keylen);
     }
-    t = DynArray_get(oTokens, i);
-    if (t->pcValue == NULL) {
-      switch (t->eType) {
-      case TOKEN_PIPE:
-        if (pipe(fd_pipe) < 0) {
-          errorPrint(strerror(errno), FPRINTF);
-          if (argv != NULL)
-            free(argv);
-          for (j = 0; j < cur_pidv; j++)
-            waitpid(pidv[j], NULL, 0);
-          free(pidv);
-          return;
-        }
-        assert(fd_out == 1);
-        pidv[cur_pidv++] = do_exec(argv, fd_in, fd_pipe[1]);
-        // Set value for next exec
-        free(argv);
-        argv = NULL;
-        fd_in = fd_pipe[0];
-        fd_out = 1;
-        break;
-      case TOKEN_REDIN:
-      case TOKEN_REDOUT:
-        t_state = t->eType;
-        break;
-      case TOKEN_BG:
-        /* All child processes forked by your program should run in the
-         * foreground.
-         */
+    if (!read &&
+        !Lexer_init(&sLexer, &line->sLine, LEXMODE_SHELL, &line->sPipeline)) {
+      /* no arena for the line; drop it, and skip the rest of it below */
+      read = TRUE;
+      lexcheck = LEX_NOMEM;
+      break;
+    }
+    read = TRUE;
+    lexcheck = Lexer_feed(&sLexer, acChunk, len);
+  }
+  if (echo)
+    fflush(stdout);
+
+  /* The lexer may stop before the end of the line, e.g. on an
+   * error; skip the rest of it so it is not run as the next line. */
+  if (read && !newline) {
+    while (readChunk(fp, acChunk, sizeof(acChunk), &len)) {
+      if (echo)
+        fputs(acChunk, stdout);
+      if (len > 0 && acChunk[len - 1] == '\n')
         break;
-      case TOKEN_WORD:
-      default:
-        assert(0 && "Unreachable");
-      }
-    } else {
-      if (t_state == TOKEN_REDIN) {
-        assert(fd_in == 0);
-        fd_in = open(t->pcValue, O_RDONLY);
-        if (fd_in < 0) {
-          errorPrint(strerror(errno), FPRINTF);
-          if (argv != NULL)
-            free(argv);
-          for (j = 0; j < cur_pidv; j++)
-            waitpid(pidv[j], NULL, 0);
-          free(pidv);
-          return;
-        }
-        t_state = TOKEN_WORD;
-      } else if (t_state == TOKEN_REDOUT) {
-        assert(fd_out == 1);
-        /* O_CREAT: Your program should create a file if the command's output is
-         * redirected to a non-existing file.
-         * O_TRUNC: Your program should truncate a file if the command's output
-         * is redirect to an existing file. */
-        fd_out = open(t->pcValue, O_WRONLY | O_CREAT | O_TRUNC, 0600);
-        if (fd_out < 0) {
-          errorPrint(strerror(errno), FPRINTF);
-          if (argv != NULL)
-            free(argv);
-          for (j = 0; j < cur_pidv; j++)
-            waitpid(pidv[j], NULL, 0);
-          free(pidv);
-          return;
-        }
-        t_state = TOKEN_WORD;
-      } else {
-        assert(t_state == TOKEN_WORD);
-        argv[cur_argv++] = t->pcValue;
-      }
     }
   }
-  pidv[cur_pidv++] = do_exec(argv, fd_in, fd_out);
-  free(argv);
 
-  for (i = 0; i < pidc; i++)
-    waitpid(pidv[i], NULL, 0);
-  free(pidv);
+  /* keep a parsed one-chunk line for the next time it is read */
+  if (keylen > 0 && lexcheck == LEX_SUCCESS &&
+      TokenVec_size(&line->sLine.sTokens) > 0) {
+    psEntry = ParseCache_insert(acKey, keylen, &line->sLine,
+                                &line->sPipeline);
+    if (psEntry != NULL) {
+      line->psLine = &psEntry->sLine;
+      line->psPipeline = &psEntry->sPipeline;
+    }
+  }
+
+  line->lexcheck = lexcheck;
+  return TRUE;
 }
 
-static void shellHelper(const char *inLine) {
-  DynArray_T oTokens;
+static void releaseLine(struct Line *line) {
+  /* free the line read by readLine() unless the parse cache owns it
+   * @line: line to free
+   */
+  if (line->psLine == &line->sLine) {
+    Pipeline_free(&line->sPipeline);
+    TokenLine_free(&line->sLine);
+  }
+}
 
-  enum LexResult lexcheck;
+static void shellHelper(const struct TokenLine *psLine,
+                        const struct Pipeline *psPipeline,
+                        enum LexResult lexcheck) {
   enum SyntaxResult syncheck;
-  enum BuiltinType btype;
-
-  oTokens = DynArray_new(0);
-  if (oTokens == NULL) {
-    errorPrint("Cannot allocate memory", FPRINTF);
-    exit(EXIT_FAILURE);
-  }
+  const struct Builtin *psBuiltin;
+  char **argv;
+  int argc;
 
-  lexcheck = lexLine(inLine, oTokens);
   switch (lexcheck) {
   case LEX_SUCCESS:
-    if (DynArray_getLength(oTokens) == 0)
-      return;
+    if (TokenVec_size(&psLine->sTokens) == 0)
+      break;
 
     /* dump lex result when DEBUG is set */
-    dumpLex(oTokens);
+    dumpLex(psLine->oTokens);
 
-    syncheck = syntaxCheck(oTokens);
+    syncheck = psPipeline->eSyntax;
     if (syncheck == SYN_SUCCESS) {
-      btype = checkBuiltin(DynArray_get(oTokens, 0));
-      switch (btype) {
-      case NORMAL:
-        handle_normal(oTokens);
-        break;
-      case B_EXIT:
-        exit(EXIT_SUCCESS);
-      case B_SETENV:
-        switch (DynArray_getLength(oTokens)) {
-        case 0:
-          assert(0);
-          break;
-        case 2:
-          if (setenv(((struct Token *)DynArray_get(oTokens, 1))->pcValue, "",
-                     1) < 0)
-            errorPrint(strerror(errno), FPRINTF);
-          break;
-        case 3:
-          if (((struct Token *)DynArray_get(oTokens, 1))->pcValue == NULL ||
-              ((struct Token *)DynArray_get(oTokens, 1))->pcValue == NULL) {
-            errorPrint("setenv takes one or two parameters", FPRINTF);
-            break;
-          }
-          if (setenv(((struct Token *)DynArray_get(oTokens, 1))->pcValue,
-                     ((struct Token *)DynArray_get(oTokens, 2))->pcValue,
-                     1) < 0)
-            errorPrint(strerror(errno), FPRINTF);
-          break;
-        default:
-          errorPrint("setenv takes one or two parameters", FPRINTF);
-          break;
-        }
-        break;
-      case B_USETENV:
-        if (DynArray_getLength(oTokens) != 2) {
-          errorPrint("unsetenv takes one parameter", FPRINTF);
-          break;
-        }
-        if (unsetenv(((struct Token *)DynArray_get(oTokens, 1))->pcValue) < 0)
-          errorPrint(strerror(errno), FPRINTF);
-        break;
-      case B_CD:
-        switch (DynArray_getLength(oTokens)) {
-        case 0:
-          assert(0);
-          break;
-        case 1:
-          if (chdir(getenv("HOME")) < 0)
-            errorPrint(strerror(errno), FPRINTF);
-          break;
-        case 2:
-          if (chdir(((struct Token *)DynArray_get(oTokens, 1))->pcValue) < 0)
-            errorPrint(strerror(errno), FPRINTF);
-          break;
-        default:
-          errorPrint("cd takes one parameter", FPRINTF);
-          break;
-        }
-        break;
-      case B_ALIAS:
-      case B_FG:
-        errorPrint("Not implemented", FPRINTF);
-        break;
-      }
+      /* builtins take the words of the first stage */
+      argc = StageVec_at(&psPipeline->sStages, 0)->iArgc;
+      argv = psPipeline->ppcArgv + StageVec_at(&psPipeline->sStages, 0)->iArgv;
+      psBuiltin = Builtin_ofToken(TokenVec_at(&psLine->sTokens, 0));
+      if (psBuiltin != NULL && (psBuiltin->uFlags & BUILTIN_PARENT))
+        run_parent(psBuiltin, psLine, argc, argv);
+      else if (psBuiltin != NULL && StageVec_size(&psPipeline->sStages) == 1)
+        /* a lone utility runs in the shell, without a fork */
+        run_builtin_here(psBuiltin, argc, argv, psPipeline->pcRedIn,
+                         psPipeline->pcRedOut);
+      else
+        handle_normal(psPipeline);
     }
 
     /* syntax error cases */
@@ -334,10 +268,6 @@ static void shellHelper(const char *inLine) {
     errorPrint("Cannot allocate memory", FPRINTF);
     break;
 
-  case LEX_LONG:
-    errorPrint("Command is too large", FPRINTF);
-    break;
-
   default:
     errorPrint("lexLine needs to be fixed", FPRINTF);
     exit(EXIT_FAILURE);
@@ -345,12 +275,16 @@ static void shellHelper(const char *inLine) {
 }
 
 int main(int argc, char *argv[]) {
-  char acLine[MAX_LINE_SIZE + 2];
-  char filepath[MAX_LINE_SIZE];
+  struct Line line;
+  char filepath[PATH_MAX];
   FILE *ishrc;
   sigset_t signal_set;
 
   errorPrint(argv[0], SETUP);
+  if (!Builtin_init()) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    return 1;
+  }
 
   /* Your program should call the sigprocmask function near the beginning of the
    * main function to make sure that SIGINT, SIGQUIT, and SIGALRM signals are
@@ -377,25 +311,23 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  snprintf(filepath, MAX_LINE_SIZE, "%s/.ishrc", getenv("HOME"));
+  snprintf(filepath, sizeof(filepath), "%s/.ishrc", getenv("HOME"));
   if ((ishrc = fopen(filepath, "r"))) {
-    while (1) {
-      if (fgets(acLine, MAX_LINE_SIZE, ishrc) == NULL) {
-        break;
-      }
-      fprintf(stdout, "%% %s", acLine);
-      fflush(stdout);
-      shellHelper(acLine);
+    while (readLine(ishrc, &line, TRUE)) {
+      shellHelper(line.psLine, line.psPipeline, line.lexcheck);
+      releaseLine(&line);
     }
   }
 
   while (1) {
     fprintf(stdout, "%% ");
     fflush(stdout);
-    if (fgets(acLine, MAX_LINE_SIZE, stdin) == NULL) {
+    if (!readLine(stdin, &line, FALSE)) {
       printf("\n");
+      ParseCache_dumpStats();
       exit(EXIT_SUCCESS);
     }
-    shellHelper(acLine);
+    shellHelper(line.psLine, line.psPipeline, line.lexcheck);
+    releaseLine(&line);
   }
 }
@@ -0,0 +1,463 @@
+#define _GNU_SOURCE /* pipe2 */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "launch.h"
+#include "pathcache.h"
+#include "relay.h"
+#include "util.h"
+
+extern char **environ;
+
+/*--------------------------------------------------------------------*/
+/* launch.c                                                           */
+/* Start external commands.  The file to run comes from the PATH      */
+/* cache.  posix_spawn() is used by default: it does not copy the     */
+/* shell's address space, so starting a command costs the same        */
+/* however large the shell's heap grows.  Setting ISH_LAUNCH=fork     */
+/* selects the classic fork() and execve() path, which is also taken  */
+/* if the spawn attributes cannot be set up.                          */
+/*--------------------------------------------------------------------*/
+
+enum LaunchBackend launch_backend(void) {
+  /* return the backend selected by the environment
+   */
+  const char *value = getenv("ISH_LAUNCH");
+
+  if (value != NULL && strcmp(value, "fork") == 0)
+    return LAUNCH_FORK;
+  return LAUNCH_SPAWN;
+}
+
+static void close_parent_ends(int fd_in, int fd_out) {
+  /* close the fds handed to a child, unless they are the shell's own
+   * stdin and stdout
+   */
+  if (fd_in != FD_IN)
+    close(fd_in);
+  if (fd_out != FD_OUT)
+    close(fd_out);
+}
+
+static void setup_child(int fd_in, int fd_out) {
+  /* in a forked child, restore the signals the shell handles and wire
+   * up stdin and stdout
+   * @fd_in: fd to be set as stdin
+   * @fd_out: fd to be set as stdout
+   */
+  if (signal(SIGINT, SIG_DFL) == SIG_ERR) {
+    errorPrint(strerror(errno), FPRINTF);
+    exit(EXIT_FAILURE);
+  }
+  if (signal(SIGQUIT, SIG_DFL) == SIG_ERR) {
+    errorPrint(strerror(errno), FPRINTF);
+    exit(EXIT_FAILURE);
+  }
+  if (signal(SIGALRM, SIG_DFL) == SIG_ERR) {
+    errorPrint(strerror(errno), FPRINTF);
+    exit(EXIT_FAILURE);
+  }
+  if (fd_in != FD_IN) {
+    dup2(fd_in, FD_IN);
+    close(fd_in);
+  }
+  if (fd_out != FD_OUT) {
+    dup2(fd_out, FD_OUT);
+    close(fd_out);
+  }
+}
+
+static int launch_fork(const char *path, char **argv, int fd_in,
+                       int fd_out) {
+  /* fork a process and execve
+   * @path: file to execute
+   * @argv: argument vector
+   * @fd_in: fd to be set as stdin of the child process
+   * @fd_out: fd to be set as stdout of the child process
+   */
+  int pid;
+
+  /* Your program should call fflush(NULL) before each call of fork to clear all
+   * I/O buffers.
+   */
+  fflush(stdout);
+  if ((pid = fork()) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+    close_parent_ends(fd_in, fd_out);
+    return pid;
+  } else if (pid == 0) {
+    setup_child(fd_in, fd_out);
+    execve(path, argv, environ);
+    /* the cached file has gone away: search PATH as before */
+    if (errno == ENOENT && path != argv[0])
+      execvp(argv[0], argv);
+    errorPrint(argv[0], SETUP);
+    errorPrint(strerror(errno), FPRINTF);
+    exit(EXIT_FAILURE);
+  }
+
+  close_parent_ends(fd_in, fd_out);
+  return pid;
+}
+
+static int launch_spawn(const char *path, char **argv, int fd_in,
+                        int fd_out, Arena_T paths) {
+  /* start path with posix_spawn, expressing the fd wiring as file
+   * actions and the signal resets of launch_fork as spawn attributes;
+   * fall back to launch_fork if they cannot be set up
+   * @path: file to execute
+   * @argv: argument vector
+   * @fd_in: fd to be set as stdin of the child process
+   * @fd_out: fd to be set as stdout of the child process
+   * @paths: arena for a path looked up again, see PathCache_resolve
+   */
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  sigset_t defaults;
+  pid_t pid;
+  int err;
+
+  if (posix_spawn_file_actions_init(&actions) != 0)
+    return launch_fork(path, argv, fd_in, fd_out);
+  if (posix_spawnattr_init(&attr) != 0) {
+    posix_spawn_file_actions_destroy(&actions);
+    return launch_fork(path, argv, fd_in, fd_out);
+  }
+
+  sigemptyset(&defaults);
+  sigaddset(&defaults, SIGINT);
+  sigaddset(&defaults, SIGQUIT);
+  sigaddset(&defaults, SIGALRM);
+  err = posix_spawnattr_setsigdefault(&attr, &defaults);
+  if (err == 0)
+    err = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+  if (err == 0 && fd_in != FD_IN) {
+    err = posix_spawn_file_actions_adddup2(&actions, fd_in, FD_IN);
+    if (err == 0)
+      err = posix_spawn_file_actions_addclose(&actions, fd_in);
+  }
+  if (err == 0 && fd_out != FD_OUT) {
+    err = posix_spawn_file_actions_adddup2(&actions, fd_out, FD_OUT);
+    if (err == 0)
+      err = posix_spawn_file_actions_addclose(&actions, fd_out);
+  }
+  if (err != 0) {
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    return launch_fork(path, argv, fd_in, fd_out);
+  }
+
+  fflush(stdout);
+  err = posix_spawn(&pid, path, &actions, &attr, argv, environ);
+  if (err == ENOENT && PathCache_isCached(argv[0])) {
+    /* the cached file has gone away: look it up again */
+    PathCache_forget(argv[0]);
+    path = PathCache_resolve(argv[0], SYMBOL_NONE, paths);
+    if (path != NULL)
+      err = posix_spawn(&pid, path, &actions, &attr, argv, environ);
+  }
+  posix_spawnattr_destroy(&attr);
+  posix_spawn_file_actions_destroy(&actions);
+  close_parent_ends(fd_in, fd_out);
+
+  if (err != 0) {
+    /* the exec failed in the child; report it as the child would have */
+    errno = err;
+    errorPrint(argv[0], PERROR);
+    return -1;
+  }
+  return pid;
+}
+
+int launch_command(char **argv, int symbol, int fd_in, int fd_out) {
+  /* start the command argv with the selected backend; the fds are
+   * closed in the shell once the child has them
+   * @argv: argument vector
+   * @symbol: symbol id of argv[0], or SYMBOL_NONE if it is not known
+   * @fd_in: fd to be set as stdin of the child process
+   * @fd_out: fd to be set as stdout of the child process
+   * return the child's pid, or -1 if it could not be started
+   */
+  Arena_T paths;
+  const char *path;
+  int pid;
+
+  assert(argv != NULL && fd_in >= 0 && fd_out >= 0);
+
+#ifdef JB_DEBUG
+  if (getenv("DEBUG") != NULL) {
+    int i;
+    fprintf(stderr, "Exec: ");
+    for (i = 0; argv[i] != NULL; i++)
+      fprintf(stderr, "%s ", argv[i]);
+    fprintf(stderr, "/ fd_in: %d, fd_out: %d\n", fd_in, fd_out);
+  }
+#endif
+
+  /* holds the path if the PATH cache cannot keep it, until the child
+   * has been started */
+  if ((paths = Arena_new()) == NULL) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    close_parent_ends(fd_in, fd_out);
+    return -1;
+  }
+  path = PathCache_resolve(argv[0], symbol, paths);
+  if (path == NULL) {
+    errno = ENOENT;
+    errorPrint(argv[0], PERROR);
+    close_parent_ends(fd_in, fd_out);
+    pid = -1;
+  } else if (launch_backend() == LAUNCH_FORK)
+    pid = launch_fork(path, argv, fd_in, fd_out);
+  else
+    pid = launch_spawn(path, argv, fd_in, fd_out, paths);
+  Arena_free(paths);
+  return pid;
+}
+
+static int fork_builtin(int (*run)(int argc, char *argv[]), int argc,
+                        char **argv, int fd_in, int fd_out,
+                        const int *others, int n_others) {
+  /* run a builtin or a relay as a stage of a pipeline, in a forked
+   * child; the fds are closed in the shell once the child has them.
+   * others are closed in the child first: it does not exec, so
+   * O_CLOEXEC does not keep the pipeline's other fds out of it
+   * @run: the function to run
+   * @argc, @argv: its argument vector
+   * @fd_in: fd to be set as stdin of the child process
+   * @fd_out: fd to be set as stdout of the child process
+   * @others: fds to close in the child, -1 for none
+   * @n_others: number of entries in others
+   * return the child's pid, or -1 if it could not be started
+   */
+  int pid, status, i;
+
+  fflush(stdout);
+  if ((pid = fork()) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+  } else if (pid == 0) {
+    for (i = 0; i < n_others; i++)
+      if (others[i] >= 0 && others[i] != fd_in && others[i] != fd_out)
+        close(others[i]);
+    setup_child(fd_in, fd_out);
+    status = run(argc, argv);
+    fflush(stdout);
+    /* _exit: the shell's other stdio streams are not the child's to
+     * flush */
+    _exit(status);
+  }
+
+  close_parent_ends(fd_in, fd_out);
+  return pid;
+}
+
+static int stage_status(int wstatus) {
+  /* turn a status from waitpid into an exit status, the way sh does */
+  if (WIFEXITED(wstatus))
+    return WEXITSTATUS(wstatus);
+  if (WIFSIGNALED(wstatus))
+    return 128 + WTERMSIG(wstatus);
+  return EXIT_FAILURE;
+}
+
+static void close_fds(int *fds, int n) {
+  /* close the fds that are still open and mark them closed */
+  int i;
+
+  for (i = 0; i < n; i++)
+    if (fds[i] >= 0) {
+      close(fds[i]);
+      fds[i] = -1;
+    }
+}
+
+int launch_pipeline(const struct Pipeline *pipeline, int *status) {
+  /* run every stage of pipeline and wait for exactly those children.
+   * The redirections and all the pipes are opened first, with
+   * O_CLOEXEC, so a failure leaves nothing running and no stage
+   * inherits another's pipe ends; then every stage is started before
+   * the first is waited for.  With ISH_PIPE_SIZE the pipes are
+   * enlarged, and with ISH_RELAY pass-through stages between two pipes
+   * are relayed by the shell (see relay.c).
+   * @pipeline: parsed command line
+   * @status: receives the exit status of each stage: 127 if it could
+   *   not be started, 128+n if it was killed by signal n; every entry
+   *   is EXIT_FAILURE if the pipeline could not be set up
+   * return the exit status of the last stage
+   */
+  const struct Stage *stage;
+  const struct Builtin *builtin;
+  char **argv;
+  pid_t *pidv;
+  int *fds;       /* redin, redout, then the read and write end of each
+                   * pipe; -1 once closed or handed to a child */
+  int n_stages, n_fds, pipe_size, relay;
+  int fd_in, fd_out, wstatus;
+  int i;
+
+  assert(pipeline != NULL && status != NULL);
+
+  n_stages = StageVec_size(&pipeline->sStages);
+  n_fds = 2 * n_stages;
+  for (i = 0; i < n_stages; i++)
+    status[i] = EXIT_FAILURE;
+  pidv = calloc((size_t)n_stages, sizeof(pid_t));
+  fds = malloc((size_t)n_fds * sizeof(int));
+  if (pidv == NULL || fds == NULL) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    free(pidv);
+    free(fds);
+    return EXIT_FAILURE;
+  }
+  for (i = 0; i < n_fds; i++)
+    fds[i] = -1;
+
+  if (pipeline->pcRedIn != NULL &&
+      (fds[0] = open(pipeline->pcRedIn, O_RDONLY | O_CLOEXEC)) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+    goto out;
+  }
+  pipe_size = n_stages > 1 ? relay_pipe_size() : 0;
+  relay = n_stages > 2 && relay_enabled();
+  for (i = 0; i < n_stages - 1; i++) {
+    if (pipe2(fds + 2 + 2 * i, O_CLOEXEC) < 0) {
+      errorPrint(strerror(errno), FPRINTF);
+      goto out;
+    }
+    if (pipe_size > 0)
+      relay_size_pipe(fds[2 + 2 * i], pipe_size);
+  }
+  /* O_CREAT: Your program should create a file if the command's output is
+   * redirected to a non-existing file.
+   * O_TRUNC: Your program should truncate a file if the command's output
+   * is redirect to an existing file. */
+  if (pipeline->pcRedOut != NULL &&
+      (fds[1] = open(pipeline->pcRedOut, O_WRONLY | O_CREAT | O_TRUNC |
+                     O_CLOEXEC, 0600)) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+    goto out;
+  }
+
+  for (i = 0; i < n_stages; i++) {
+    stage = StageVec_at(&pipeline->sStages, i);
+    /* stage i reads the pipe before it and writes the one after it */
+    fd_in = i == 0 ? fds[0] : fds[2 * i];
+    fd_out = i == n_stages - 1 ? fds[1] : fds[2 * i + 3];
+    if (fd_in < 0)
+      fd_in = FD_IN;
+    if (fd_out < 0)
+      fd_out = FD_OUT;
+
+    argv = pipeline->ppcArgv + stage->iArgv;
+    builtin = Builtin_ofSymbol(stage->iSymbol);
+    if (builtin != NULL && (builtin->uFlags & BUILTIN_PIPELINE))
+      pidv[i] = fork_builtin(builtin->pfRun, stage->iArgc, argv, fd_in,
+                             fd_out, fds, n_fds);
+    else if (relay && i > 0 && i < n_stages - 1 &&
+             relay_stage(stage->iArgc, argv, stage->iSymbol))
+      pidv[i] = fork_builtin(relay_run, stage->iArgc, argv, fd_in, fd_out,
+                             fds, n_fds);
+    else
+      pidv[i] = launch_command(argv, stage->iSymbol, fd_in, fd_out);
+    /* both ends now belong to the child, and the shell has closed them */
+    if (i == 0)
+      fds[0] = -1;
+    else
+      fds[2 * i] = -1;
+    if (i == n_stages - 1)
+      fds[1] = -1;
+    else
+      fds[2 * i + 3] = -1;
+    if (pidv[i] < 0)
+      status[i] = 127;
+  }
+
+  /* All child processes forked by your program should run in the
+   * foreground.
+   */
+  for (i = 0; i < n_stages; i++) {
+    if (pidv[i] <= 0)
+      continue;
+    while (waitpid(pidv[i], &wstatus, 0) < 0) {
+      if (errno != EINTR) {
+        wstatus = EXIT_FAILURE << 8;
+        break;
+      }
+    }
+    status[i] = stage_status(wstatus);
+  }
+
+out:
+  close_fds(fds, n_fds);
+  free(fds);
+  free(pidv);
+  return status[n_stages - 1];
+}
+
+static int swap_fd(const char *path, int flags, int target, int *saved) {
+  /* open path and put it at fd target, keeping the old target in
+   * *saved
+   * return FALSE after reporting the error if it cannot be done
+   */
+  int fd;
+
+  if ((fd = open(path, flags, 0600)) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+    return FALSE;
+  }
+  if ((*saved = fcntl(target, F_DUPFD_CLOEXEC, 10)) < 0 ||
+      dup2(fd, target) < 0) {
+    errorPrint(strerror(errno), FPRINTF);
+    close(fd);
+    if (*saved >= 0)
+      close(*saved);
+    *saved = -1;
+    return FALSE;
+  }
+  close(fd);
+  return TRUE;
+}
+
+static void restore_fd(int target, int saved) {
+  /* undo swap_fd */
+  if (saved >= 0) {
+    dup2(saved, target);
+    close(saved);
+  }
+}
+
+int run_builtin_here(const struct Builtin *builtin, int argc, char **argv,
+                     const char *red_in, const char *red_out) {
+  /* run a builtin in the shell process, with stdin and stdout
+   * redirected for as long as it runs
+   * @builtin: the builtin
+   * @argc, @argv: its argument vector
+   * @red_in, @red_out: files to redirect stdin and stdout to, or NULL
+   * return its exit status
+   */
+  int saved_in = -1, saved_out = -1;
+  int status = EXIT_FAILURE;
+
+  assert(builtin != NULL && argv != NULL);
+
+  fflush(stdout);
+  if (red_in != NULL && !swap_fd(red_in, O_RDONLY, FD_IN, &saved_in))
+    return status;
+  /* O_CREAT | O_TRUNC, as for an external command */
+  if (red_out == NULL ||
+      swap_fd(red_out, O_WRONLY | O_CREAT | O_TRUNC, FD_OUT, &saved_out)) {
+    status = builtin->pfRun(argc, argv);
+    fflush(stdout);
+    restore_fd(FD_OUT, saved_out);
+  }
+  restore_fd(FD_IN, saved_in);
+  return status;
+}
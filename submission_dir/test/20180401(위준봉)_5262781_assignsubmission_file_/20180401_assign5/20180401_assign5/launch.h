@@ -0,0 +1,22 @@
+#ifndef _LAUNCH_H_
+#define _LAUNCH_H_
+
+#include "builtin.h"
+#include "pipeline.h"
+
+#define FD_IN 0
+#define FD_OUT 1
+
+/* How external commands are started. */
+enum LaunchBackend {
+  LAUNCH_SPAWN,   /* posix_spawn(): no copy of the shell's page tables */
+  LAUNCH_FORK     /* fork() and execve() */
+};
+
+enum LaunchBackend launch_backend(void);
+int launch_command(char **argv, int symbol, int fd_in, int fd_out);
+int launch_pipeline(const struct Pipeline *pipeline, int *status);
+int run_builtin_here(const struct Builtin *builtin, int argc, char **argv,
+                     const char *red_in, const char *red_out);
+
+#endif /* _LAUNCH_H_ */
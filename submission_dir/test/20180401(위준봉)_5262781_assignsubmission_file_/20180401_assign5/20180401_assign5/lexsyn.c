@@ -1,551 +1,487 @@
 #include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LEX_X86 1
+#endif
 #include "lexsyn.h"
+#include "pipeline.h"
 #include "token.h"
 #include "util.h"
 
 /*--------------------------------------------------------------------*/
+/* The lexer is a single DFA driven by constant tables: each input byte
+   is mapped to a character class, and asTrans[mode][state][class]
+   gives the next state and what to do with the byte.  The modes cover
+   every way ish splits text into words, so they cannot drift apart. */
+
+/* Character classes.  Whitespace is what isspace() accepts in the C
+   locale. */
+enum CharClass {CC_WORD, CC_SPACE, CC_END, CC_PIPE, CC_REDIN, CC_REDOUT,
+                CC_BG, CC_DQUOTE, CC_QUOTE, CC_EQUAL, CC_COUNT};
+
+static const unsigned char aucClass[256] = {
+  ['\0'] = CC_END, ['\n'] = CC_END,
+  ['\t'] = CC_SPACE, ['\v'] = CC_SPACE, ['\f'] = CC_SPACE,
+  ['\r'] = CC_SPACE, [' '] = CC_SPACE,
+  ['|'] = CC_PIPE, ['<'] = CC_REDIN, ['>'] = CC_REDOUT, ['&'] = CC_BG,
+  ['\"'] = CC_DQUOTE, ['\''] = CC_QUOTE, ['='] = CC_EQUAL,
+};
+
+/* The token made for each special character class. */
+static const enum TokenType aeSpecial[CC_COUNT] = {
+  [CC_PIPE] = TOKEN_PIPE, [CC_REDIN] = TOKEN_REDIN,
+  [CC_REDOUT] = TOKEN_REDOUT, [CC_BG] = TOKEN_BG,
+};
+
+enum LexerState {LS_START, LS_IN_WORD, LS_IN_DQUOTE, LS_IN_QUOTE,
+                 LS_IN_VALUE, LS_COUNT};
+
+/* Actions, applied in this order. */
+enum {
+  LA_WORD = 0x01,     /* end the current word and make its token */
+  LA_SPECIAL = 0x02,  /* make the token for the byte's class */
+  LA_QERROR = 0x04,   /* fail: unmatched quote or misplaced '=' */
+  LA_DONE = 0x08,     /* the line is finished */
+  LA_BEGIN = 0x10,    /* start a new word */
+  LA_APPEND = 0x20,   /* append the byte to the current word */
+};
+
+struct LexTrans {
+  unsigned char ucNext;
+  unsigned char ucAction;
+};
+
+#define T(next, action) {LS_##next, (action)}
+
+/* Designators for runs of classes that share a transition. */
+#define WORD_SPACE(t) [CC_WORD] = t, [CC_SPACE] = t
+#define SPECIALS(t) [CC_PIPE] = t, [CC_REDIN] = t, [CC_REDOUT] = t, [CC_BG] = t
+#define QUOTES(t) [CC_DQUOTE] = t, [CC_QUOTE] = t
+
+/* Rows shared by the modes that know about quotes. */
+#define DQUOTE_ROW                                                  \
+  { WORD_SPACE(T(IN_DQUOTE, LA_APPEND)),                            \
+    [CC_END] = T(START, LA_QERROR),                                 \
+    SPECIALS(T(IN_DQUOTE, LA_APPEND)),                              \
+    [CC_DQUOTE] = T(IN_WORD, 0),                                    \
+    [CC_QUOTE] = T(IN_DQUOTE, LA_APPEND),                           \
+    [CC_EQUAL] = T(IN_DQUOTE, LA_APPEND) }
+#define QUOTE_ROW                                                   \
+  { WORD_SPACE(T(IN_QUOTE, LA_APPEND)),                             \
+    [CC_END] = T(START, LA_QERROR),                                 \
+    SPECIALS(T(IN_QUOTE, LA_APPEND)),                               \
+    [CC_DQUOTE] = T(IN_QUOTE, LA_APPEND),                           \
+    [CC_QUOTE] = T(IN_WORD, 0),                                     \
+    [CC_EQUAL] = T(IN_QUOTE, LA_APPEND) }
+
+static const struct LexTrans asTrans[LEXMODE_COUNT][LS_COUNT][CC_COUNT] = {
+  /* Command lines: words, quotes and the | < > & tokens. */
+  [LEXMODE_SHELL] = {
+    [LS_START] = {
+      [CC_WORD] = T(IN_WORD, LA_BEGIN | LA_APPEND),
+      [CC_SPACE] = T(START, 0),
+      [CC_END] = T(START, LA_DONE),
+      SPECIALS(T(START, LA_SPECIAL)),
+      [CC_DQUOTE] = T(IN_DQUOTE, LA_BEGIN),
+      [CC_QUOTE] = T(IN_QUOTE, LA_BEGIN),
+      [CC_EQUAL] = T(IN_WORD, LA_BEGIN | LA_APPEND),
+    },
+    [LS_IN_WORD] = {
+      [CC_WORD] = T(IN_WORD, LA_APPEND),
+      [CC_SPACE] = T(START, LA_WORD),
+      [CC_END] = T(START, LA_WORD | LA_DONE),
+      SPECIALS(T(START, LA_WORD | LA_SPECIAL)),
+      [CC_DQUOTE] = T(IN_DQUOTE, 0),
+      [CC_QUOTE] = T(IN_QUOTE, 0),
+      [CC_EQUAL] = T(IN_WORD, LA_APPEND),
+    },
+    [LS_IN_DQUOTE] = DQUOTE_ROW,
+    [LS_IN_QUOTE] = QUOTE_ROW,
+  },
+  /* Whitespace separated words with quotes. */
+  [LEXMODE_WORDS] = {
+    [LS_START] = {
+      [CC_WORD] = T(IN_WORD, LA_BEGIN | LA_APPEND),
+      [CC_SPACE] = T(START, 0),
+      [CC_END] = T(START, LA_DONE),
+      SPECIALS(T(IN_WORD, LA_BEGIN | LA_APPEND)),
+      [CC_DQUOTE] = T(IN_DQUOTE, LA_BEGIN),
+      [CC_QUOTE] = T(IN_QUOTE, LA_BEGIN),
+      [CC_EQUAL] = T(IN_WORD, LA_BEGIN | LA_APPEND),
+    },
+    [LS_IN_WORD] = {
+      [CC_WORD] = T(IN_WORD, LA_APPEND),
+      [CC_SPACE] = T(START, LA_WORD),
+      [CC_END] = T(START, LA_WORD | LA_DONE),
+      SPECIALS(T(IN_WORD, LA_APPEND)),
+      [CC_DQUOTE] = T(IN_DQUOTE, 0),
+      [CC_QUOTE] = T(IN_QUOTE, 0),
+      [CC_EQUAL] = T(IN_WORD, LA_APPEND),
+    },
+    [LS_IN_DQUOTE] = DQUOTE_ROW,
+    [LS_IN_QUOTE] = QUOTE_ROW,
+  },
+  /* Whitespace separated words; every other byte is literal. */
+  [LEXMODE_RAW] = {
+    [LS_START] = {
+      [CC_WORD] = T(IN_WORD, LA_BEGIN | LA_APPEND),
+      [CC_SPACE] = T(START, 0),
+      [CC_END] = T(START, LA_DONE),
+      SPECIALS(T(IN_WORD, LA_BEGIN | LA_APPEND)),
+      QUOTES(T(IN_WORD, LA_BEGIN | LA_APPEND)),
+      [CC_EQUAL] = T(IN_WORD, LA_BEGIN | LA_APPEND),
+    },
+    [LS_IN_WORD] = {
+      [CC_WORD] = T(IN_WORD, LA_APPEND),
+      [CC_SPACE] = T(START, LA_WORD),
+      [CC_END] = T(START, LA_WORD | LA_DONE),
+      SPECIALS(T(IN_WORD, LA_APPEND)),
+      QUOTES(T(IN_WORD, LA_APPEND)),
+      [CC_EQUAL] = T(IN_WORD, LA_APPEND),
+    },
+  },
+  /* An alias definition: NAME=VALUE, where VALUE is the rest of the
+     line taken literally. */
+  [LEXMODE_ALIAS] = {
+    [LS_START] = {
+      WORD_SPACE(T(IN_WORD, LA_BEGIN | LA_APPEND)),
+      [CC_END] = T(START, LA_DONE),
+      SPECIALS(T(IN_WORD, LA_BEGIN | LA_APPEND)),
+      QUOTES(T(IN_WORD, LA_BEGIN | LA_APPEND)),
+      [CC_EQUAL] = T(START, LA_QERROR),
+    },
+    [LS_IN_WORD] = {
+      WORD_SPACE(T(IN_WORD, LA_APPEND)),
+      [CC_END] = T(START, LA_WORD | LA_DONE),
+      SPECIALS(T(IN_WORD, LA_APPEND)),
+      QUOTES(T(IN_WORD, LA_APPEND)),
+      [CC_EQUAL] = T(IN_VALUE, LA_WORD | LA_BEGIN),
+    },
+    [LS_IN_VALUE] = {
+      WORD_SPACE(T(IN_VALUE, LA_APPEND)),
+      [CC_END] = T(START, LA_WORD | LA_DONE),
+      SPECIALS(T(IN_VALUE, LA_APPEND)),
+      QUOTES(T(IN_VALUE, LA_APPEND)),
+      [CC_EQUAL] = T(IN_VALUE, LA_APPEND),
+    },
+  },
+};
+
+#undef T
+#undef WORD_SPACE
+#undef SPECIALS
+#undef QUOTES
+#undef DQUOTE_ROW
+#undef QUOTE_ROW
 
-static int
-createToken(DynArray_T oTokens, enum TokenType ttype, char *value) {
-  struct Token *psToken;
-
-  psToken = makeToken(ttype, value);
-  if (psToken == NULL) {
-    errorPrint("Cannot allocate memory", FPRINTF);
-    return FALSE;
-  }
-  if (! DynArray_add(oTokens, psToken)) {
-    errorPrint("Cannot allocate memory", FPRINTF);
-    return FALSE;
+/*--------------------------------------------------------------------*/
+/* Run scanning.  Most bytes just get appended to the current word, so
+   after the first one the lexer asks appendSpan() how many of the
+   following bytes do the same.  For shell words, which are the bulk of
+   every command line, wordSpan() answers 16 or 32 bytes at a time.  A
+   shell word ends at whitespace, one of | < > &, a quote or the
+   terminating '\0'. */
+
+static size_t
+wordSpanScalar(const char *pc, size_t uMax) {
+  size_t u;
+  enum CharClass eClass;
+
+  for (u = 0; u < uMax; u++) {
+    eClass = (enum CharClass)aucClass[(unsigned char)pc[u]];
+    if ((eClass != CC_WORD) && (eClass != CC_EQUAL))
+      break;
   }
-  return TRUE;
+  return u;
 }
 
-/*--------------------------------------------------------------------*/
-void command_lexLine(const char *pcLine, DynArray_T cTokens)
-{
-  enum commandState {STATE_START, STATE_IN_WORD};
-  enum commandState cState = STATE_START;
-
-  int iLineIndex = 0;
-  int iValueIndex = 0;
-  char c;
-  char acValue[MAX_LINE_SIZE];
-
-  assert(pcLine != NULL);
-  assert(cTokens != NULL);
-
-  for (;;){
-    if(iLineIndex == MAX_LINE_SIZE)
-      return ;
-
-    c = pcLine[iLineIndex++];
-
-    switch(cState) {
-      case STATE_START:
-        if ((c == '\n') || (c == '\0'))
-          return ;
-        else if (isspace(c))
-          cState = STATE_START;
-        else {
-          acValue[iValueIndex++] = c;
-          cState = STATE_IN_WORD;
-        }
-        break;
+#ifdef LEX_X86
+/* The vector scanners only issue aligned loads.  An aligned block that
+   holds at least one byte of the string cannot cross a page boundary,
+   so reading the rest of the block is safe even past the '\0'. */
+
+static unsigned int
+delimMask16(__m128i v) {
+  __m128i m, t;
+
+  /* '\t' .. '\r' are contiguous: (c - 9) <= 4 as an unsigned byte. */
+  t = _mm_sub_epi8(v, _mm_set1_epi8(9));
+  m = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(4)), t);
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('|')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('<')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('&')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\"')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+  return (unsigned int)_mm_movemask_epi8(m);
+}
 
-      case STATE_IN_WORD:
-        if ((c == '\n') || (c == '\0')) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(cTokens, TOKEN_WORD, acValue) == FALSE)
-            return ;
-
-          iValueIndex = 0;
-
-          return;
-        } else if (isspace(c)) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(cTokens, TOKEN_WORD, acValue) == FALSE)
-            return ;
-
-          iValueIndex = 0;
-
-          cState = STATE_START;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          cState = STATE_IN_WORD;
-        }
+static size_t
+wordSpanSSE2(const char *pc, size_t uMax) {
+  size_t uMis = (uintptr_t)pc & 15;
+  const __m128i *pBlock = (const __m128i *)(pc - uMis);
+  unsigned int uMask;
+  size_t uSpan;
+
+  uMask = delimMask16(_mm_load_si128(pBlock)) >> uMis;
+  if (uMask != 0)
+    uSpan = (size_t)__builtin_ctz(uMask);
+  else {
+    uSpan = 16 - uMis;
+    while (uSpan < uMax) {
+      uMask = delimMask16(_mm_load_si128(++pBlock));
+      if (uMask != 0) {
+        uSpan += (size_t)__builtin_ctz(uMask);
         break;
-      default:
-        assert(FALSE);
+      }
+      uSpan += 16;
     }
-
   }
+  return (uSpan < uMax) ? uSpan : uMax;
 }
 
-enum AliasResult
-alias_lexLine(const char *pcLine, DynArray_T oTokens){
-  enum aliasState {STATE_START, STATE_IN_WORD, STATE_IN_EQUAL};
-  enum aliasState aState = STATE_START;
-
-  int iLineIndex = 0;
-  int iValueIndex = 0;
-  char c;
-  char acValue[MAX_LINE_SIZE];
-
-  assert(pcLine != NULL);
-  assert(oTokens != NULL);
-
-  for (;;){
-    if(iLineIndex == MAX_LINE_SIZE)
-      return ALIAS_LONG;
-
-    c = pcLine[iLineIndex++];
-
-    switch(aState) {
-      case STATE_START:
-        if ((c == '\n') || (c == '\0'))
-          return ALIAS_SUCCESS;
-        else if(c == '=') {
-          return ALIAS_QERROR;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          aState = STATE_IN_WORD;
-        }
-        break;
+__attribute__((target("avx2"))) static unsigned int
+delimMask32(__m256i v) {
+  __m256i m, t;
+
+  t = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+  m = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(4)), t);
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('|')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('&')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+  return (unsigned int)_mm256_movemask_epi8(m);
+}
 
-      case STATE_IN_WORD:
-        if ((c == '\n') || (c == '\0')) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return ALIAS_QERROR;
-
-          iValueIndex = 0;
-
-          return ALIAS_SUCCESS;
-        }
-        else if (c == '=') {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return ALIAS_QERROR;
-
-          iValueIndex = 0;
-
-          aState = STATE_IN_EQUAL;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          aState = STATE_IN_WORD;
-        }
+__attribute__((target("avx2"))) static size_t
+wordSpanAVX2(const char *pc, size_t uMax) {
+  size_t uMis = (uintptr_t)pc & 31;
+  const __m256i *pBlock = (const __m256i *)(pc - uMis);
+  unsigned int uMask;
+  size_t uSpan;
+
+  uMask = delimMask32(_mm256_load_si256(pBlock)) >> uMis;
+  if (uMask != 0)
+    uSpan = (size_t)__builtin_ctz(uMask);
+  else {
+    uSpan = 32 - uMis;
+    while (uSpan < uMax) {
+      uMask = delimMask32(_mm256_load_si256(++pBlock));
+      if (uMask != 0) {
+        uSpan += (size_t)__builtin_ctz(uMask);
         break;
-      case STATE_IN_EQUAL:
-        if ((c == '\n') || (c == '\0')) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return ALIAS_QERROR;
-
-          iValueIndex = 0;
-
-          return ALIAS_SUCCESS;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          aState = STATE_IN_EQUAL;
-        }
-        break;
-      default:
-        assert(FALSE);
+      }
+      uSpan += 32;
     }
-
   }
-
+  return (uSpan < uMax) ? uSpan : uMax;
+}
+#endif
+
+static size_t
+wordSpanSelect(const char *pc, size_t uMax);
+
+static size_t (*pfWordSpan)(const char *pc, size_t uMax) = wordSpanSelect;
+
+static size_t
+wordSpanSelect(const char *pc, size_t uMax) {
+  /* Pick the widest scanner the CPU supports on first use. */
+#ifdef LEX_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    pfWordSpan = wordSpanAVX2;
+  else if (__builtin_cpu_supports("sse2"))
+    pfWordSpan = wordSpanSSE2;
+  else
+#endif
+    pfWordSpan = wordSpanScalar;
+  return pfWordSpan(pc, uMax);
 }
 
-enum LexResult
-lexLine_quote(const char *pcLine, DynArray_T oTokens) {
-
-  /* lexLine() uses a DFA approach.  It "reads" its characters from
-     pcLine. The difference from 'lexLine' is about STATE_IN_QUOTE
-     here, we consider ' ' as a token like double quote
-FIXME: The reason why we use duplicated-like function is simple 'lexLine' lesical analysis guide-line in EE209
-shows ' as a normal character, not quotes.
-So, we need to handle this as a normal character in general lesical analysis.
-*/
-
-  enum LexState {STATE_START, STATE_IN_NUMBER, STATE_IN_WORD, STATE_IN_DQUOTE, STATE_IN_QUOTE};
-
-  enum LexState eState = STATE_START;
-
-  int iLineIndex = 0;
-  int iValueIndex = 0;
-  char c;
-  char acValue[MAX_LINE_SIZE];
-
-  assert(pcLine != NULL);
-  assert(oTokens != NULL);
-
-  for (;;) {
-    if (iLineIndex == MAX_LINE_SIZE)
-      return LEX_LONG;
-    /* "Read" the next character from pcLine. */
-    c = pcLine[iLineIndex++];
-
-    switch (eState) {
-      case STATE_START:
-        if ((c == '\n') || (c == '\0'))
-          return LEX_SUCCESS;
-        else if (isspace(c))
-          eState = STATE_START;
-        else if (c == '\"') {
-          eState = STATE_IN_DQUOTE;
-        }
-        else if (c == '\'') {
-          eState = STATE_IN_QUOTE;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          eState = STATE_IN_WORD;
-        }
-        break;
-      case STATE_IN_QUOTE:
-        if (c == '\'')
-          eState = STATE_IN_WORD;
-        else if ((c == '\n') || (c == '\0'))
-          return LEX_QERROR;
-        else
-          acValue[iValueIndex++] = c;
-        break;
-      case STATE_IN_WORD:
-        if ((c == '\n') || (c == '\0')) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          return LEX_SUCCESS;
-        } else if (isspace(c)) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          eState = STATE_START;
-        }
-        else if (c == '\"') {
-          eState = STATE_IN_DQUOTE;
-        }
-        else if( c== '\'' ){
-          eState = STATE_IN_QUOTE;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          eState = STATE_IN_WORD;
-        }
-        break;
-      case STATE_IN_DQUOTE:
-        if (c == '\"')
-          eState = STATE_IN_WORD;
-        else if ((c == '\n') || (c == '\0'))
-          return LEX_QERROR;
-        else
-          acValue[iValueIndex++] = c;
+static size_t
+wordSpan(const char *pc, size_t uMax) {
+  /* Return the number of plain word bytes at the start of pc, looking
+     at no more than uMax bytes. */
+  return pfWordSpan(pc, uMax);
+}
 
-        break;
-      default:
-        assert(FALSE);
-    }
+static size_t
+appendSpan(int iMode, enum LexerState eState, const char *pc,
+    size_t uMax) {
+  /* Return the number of bytes at the start of pc, looking at no more
+     than uMax bytes, that the DFA appends to the current word while
+     staying in eState. */
+  const struct LexTrans *psRow = asTrans[iMode][eState];
+  const struct LexTrans *psTrans;
+  size_t u;
+
+  if ((iMode == LEXMODE_SHELL) && (eState == LS_IN_WORD))
+    return wordSpan(pc, uMax);
+
+  for (u = 0; u < uMax; u++) {
+    psTrans = &psRow[aucClass[(unsigned char)pc[u]]];
+    if ((psTrans->ucAction != LA_APPEND) || (psTrans->ucNext != eState))
+      break;
   }
+  return u;
 }
 
+/*--------------------------------------------------------------------*/
+/* The DFA state lives in a struct Lexer, so a line can be fed to it in
+   chunks of any size and lexing resumes where the last chunk stopped,
+   even in the middle of a word or a quote.  Word values are appended
+   to the TokenLine's buffer with their quotes removed, so memory grows
+   with the tokens rather than the raw line. */
 
-enum LexResult
-lexLine(const char *pcLine, DynArray_T oTokens) {
-
-  /* lexLine() uses a DFA approach.  It "reads" its characters from
-     pcLine. */
-
-  enum LexState {STATE_START, STATE_IN_NUMBER, STATE_IN_WORD, STATE_IN_DQUOTE, STATE_IN_QUOTE};
-
-  enum LexState eState = STATE_START;
-
-  int iLineIndex = 0;
-  int iValueIndex = 0;
-  char c;
-  char acValue[MAX_LINE_SIZE];
-
-  assert(pcLine != NULL);
-  assert(oTokens != NULL);
-
-  for (;;) {
-    if (iLineIndex == MAX_LINE_SIZE)
-      return LEX_LONG;
-    /* "Read" the next character from pcLine. */
-    c = pcLine[iLineIndex++];
-
-    switch (eState) {
-      case STATE_START:
-        if ((c == '\n') || (c == '\0'))
-          return LEX_SUCCESS;
-        else if (isspace(c))
-          eState = STATE_START;
-        else if (c == '|') {
-          /* Create a PIPE token. */
-          if (createToken(oTokens, TOKEN_PIPE, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          eState = STATE_START;
-        }
-        else if (c == '&') {
-          // Create a Background command token.
-          if (createToken(oTokens, TOKEN_BG, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          eState = STATE_START;
-        }
-        else if (c == '>') {
-          /* Create a REDOUT token. */
-          if (createToken(oTokens, TOKEN_REDOUT, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          eState = STATE_START;
-        } else if (c == '<') {
-          /* Create a PIPE token. */
-          if (createToken(oTokens, TOKEN_REDIN, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          eState = STATE_START;
-        } else if (c == '\"') {
-          eState = STATE_IN_DQUOTE;
-        }
-
-        else if (c == '\'') {
-          eState = STATE_IN_QUOTE;
-        }
-
-        else {
-          acValue[iValueIndex++] = c;
-          eState = STATE_IN_WORD;
-        }
-        break;
+static int
+appendValue(struct Lexer *psLexer, const char *pc, size_t uLength) {
+  if (TokenLine_append(psLexer->psLine, pc, uLength) == FALSE) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    return FALSE;
+  }
+  return TRUE;
+}
 
-      case STATE_IN_WORD:
-        if ((c == '\n') || (c == '\0')) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          return LEX_SUCCESS;
-        } else if (isspace(c)) {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          eState = STATE_START;
-        } else if (c == '|') {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          /* Create a PIPE token. */
-          if (createToken(oTokens, TOKEN_PIPE, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          eState = STATE_START;
-        } else if (c == '>') {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          /* Create a REDOUT token. */
-
-          if (createToken(oTokens, TOKEN_REDOUT, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          eState = STATE_START;
-        } else if (c == '<') {
-          /* Create a WORD token. */
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-          /* Create a REDIN token. */
-          if (createToken(oTokens, TOKEN_REDIN, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-
-          eState = STATE_START;
-        }
-        else if (c == '&') {
-          // Create a WORD token
-
-          acValue[iValueIndex] = '\0';
-          if (createToken(oTokens, TOKEN_WORD, acValue) == FALSE)
-            return LEX_NOMEM;
-
-
-          // Create a Background command token.
-          if (createToken(oTokens, TOKEN_BG, NULL) == FALSE)
-            return LEX_NOMEM;
-
-          iValueIndex = 0;
-          eState = STATE_START;
-        }
-        else if (c == '\"') {
-          eState = STATE_IN_DQUOTE;
-        }
-        else if (c == '\'') {
-          eState = STATE_IN_QUOTE;
-        }
-        else {
-          acValue[iValueIndex++] = c;
-          eState = STATE_IN_WORD;
-        }
-        break;
-      case STATE_IN_DQUOTE:
-        if (c == '\"')
-          eState = STATE_IN_WORD;
-        else if ((c == '\n') || (c == '\0'))
-          return LEX_QERROR;
-        else
-          acValue[iValueIndex++] = c;
+static int
+addToken(struct Lexer *psLexer, enum TokenType ttype,
+    int iOffset, int iLength) {
+  if ((TokenLine_add(psLexer->psLine, ttype, iOffset, iLength) == FALSE) ||
+      ((psLexer->psPipeline != NULL) &&
+       (Pipeline_addToken(psLexer->psPipeline, ttype) == FALSE))) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    return FALSE;
+  }
+  return TRUE;
+}
 
-        break;
+static int
+endWord(struct Lexer *psLexer) {
+  /* Terminate the value of the current word and create its token. */
+  int iLength = CharVec_size(&psLexer->psLine->sBuf) - psLexer->iValueStart;
 
-      case STATE_IN_QUOTE:
-        if (c == '\'')
-          eState = STATE_IN_WORD;
-        else if ((c == '\n') || (c == '\0'))
-          return LEX_QERROR;
-        else
-          acValue[iValueIndex++] = c;
-        break;
-      default:
-        assert(FALSE);
-    }
+  if (appendValue(psLexer, "", 1) == FALSE)
+    return FALSE;
+  return addToken(psLexer, TOKEN_WORD, psLexer->iValueStart, iLength);
+}
+
+static enum LexResult
+finishLine(struct Lexer *psLexer) {
+  if ((TokenLine_finish(psLexer->psLine) == FALSE) ||
+      ((psLexer->psPipeline != NULL) &&
+       (Pipeline_finish(psLexer->psPipeline, psLexer->psLine) == FALSE))) {
+    errorPrint("Cannot allocate memory", FPRINTF);
+    return LEX_NOMEM;
   }
+  return LEX_SUCCESS;
 }
 
-enum SyntaxResult
-syntaxCheck(DynArray_T oTokens) {
-  int i;
-  enum SyntaxResult ret = SYN_SUCCESS;
-  int riexist = FALSE, roexist = FALSE, pexist = FALSE;
-  struct Token *t, *t1;
-
-  assert(oTokens);
-
-  for (i = 0; i < DynArray_getLength(oTokens); i++) {
-    t = DynArray_get(oTokens, i);
-    if (i == 0) {
-      if (t->eType != TOKEN_WORD) {
-        /* Missing command name */
-        ret = SYN_FAIL_NOCMD;
-        break;
-      }
-    } else {
-      if (t->eType == TOKEN_PIPE) {
-        /* No redout in previous tokens and no consecutive pipe in following tokens */
-        if (roexist == TRUE) {
-          /* Multiple redirection error */
-          ret = SYN_FAIL_MULTREDOUT;
-          break;
-        } else {
-          if (i == DynArray_getLength(oTokens)-1) {
-            /* Redirection without destination */
-            ret = SYN_FAIL_NOCMD;
-            break;
-          }
-          else {
-            t1 = DynArray_get(oTokens, i+1);
-            if (t1->eType != TOKEN_WORD) {
-              /* Redirection without destination */
-              ret = SYN_FAIL_NOCMD;
-              break;
-            }
-          }
-          pexist = TRUE;
-        }
-      }
-      else if (t->eType == TOKEN_BG) {
-        if (i != DynArray_getLength(oTokens) - 1) {
-          ret = SYN_FAIL_INVALIDBG;
-          break;
-        }
-      }
-      else if (t->eType == TOKEN_REDIN) {
-        /* No pipe in previous tokens and no redin in following tokens */
-        if ((pexist == TRUE) || (riexist == TRUE)) {
-          /* Multiple redirection error */
-          ret = SYN_FAIL_MULTREDIN;
-          break;
-        } else {
-          if (i == DynArray_getLength(oTokens)-1) {
-            /* Redirection without destination */
-            ret = SYN_FAIL_NODESTIN;
-            break;
-          }
-          else {
-            t1 = DynArray_get(oTokens, i+1);
-            if (t1->eType != TOKEN_WORD) {
-              /* Redirection without destination */
-              ret = SYN_FAIL_NODESTIN;
-              break;
-            }
-          }
-          riexist = TRUE;
-        }
-      } else if (t->eType == TOKEN_REDOUT) {
-        /* No redout in following tokens */
-        if (roexist == TRUE) {
-          /* Multiple redirection error */
-          ret = SYN_FAIL_MULTREDOUT;
-          break;
-        } else {
-          if (i == DynArray_getLength(oTokens)-1) {
-            /* Redirection without destination */
-            ret = SYN_FAIL_NODESTOUT;
-            break;
-          }
-          else {
-            t1 = DynArray_get(oTokens, i+1);
-            if (t1->eType != TOKEN_WORD) {
-              /* Redirection without destination */
-              ret = SYN_FAIL_NODESTOUT;
-              break;
-            }
-          }
-          roexist = TRUE;
-        }
-      }
+/*--------------------------------------------------------------------*/
+
+int
+Lexer_init(struct Lexer *psLexer, struct TokenLine *psLine,
+    enum LexMode eMode, struct Pipeline *psPipeline) {
+
+  /* Start lexing a new line into psLine, which is (re)initialized,
+     splitting it into words as eMode says.  If psPipeline is not NULL,
+     it is (re)initialized and parses the tokens as they are made.
+     Return FALSE (0) if insufficient memory is available for psLine;
+     nothing may then be fed to psLexer, and only psLine needs to be
+     freed. */
+
+  assert(psLexer != NULL);
+  assert(psLine != NULL);
+  assert((eMode >= 0) && (eMode < LEXMODE_COUNT));
+
+  psLexer->iMode = eMode;
+  psLexer->iState = LS_START;
+  psLexer->iValueStart = 0;
+  psLexer->psLine = psLine;
+  psLexer->psPipeline = psPipeline;
+  if (TokenLine_init(psLine) == FALSE)
+    return FALSE;
+  if (psPipeline != NULL)
+    Pipeline_init(psPipeline, psLine->oArena);
+  return TRUE;
+}
+
+/*--------------------------------------------------------------------*/
+
+enum LexResult
+Lexer_feed(struct Lexer *psLexer, const char *pcChunk, size_t uLength) {
+
+  /* Lex the next uLength bytes of the line.  Return LEX_MORE if the
+     line has not ended yet.  Otherwise the line ended at a '\n' or
+     '\0' in pcChunk, the rest of pcChunk is ignored, and the result is
+     final. */
+
+  const struct LexTrans (*pasRows)[CC_COUNT];
+  const struct LexTrans *psTrans;
+  enum LexerState eState;
+  unsigned char ucClass;
+  size_t uIndex = 0;
+  size_t uSpan;
+
+  assert(psLexer != NULL);
+  assert(pcChunk != NULL);
+
+  pasRows = asTrans[psLexer->iMode];
+  eState = (enum LexerState)psLexer->iState;
+
+  while (uIndex < uLength) {
+    /* "Read" the next character from pcChunk. */
+    ucClass = aucClass[(unsigned char)pcChunk[uIndex]];
+    psTrans = &pasRows[eState][ucClass];
+
+    if (psTrans->ucAction & LA_WORD)
+      if (endWord(psLexer) == FALSE)
+        return LEX_NOMEM;
+    if (psTrans->ucAction & LA_SPECIAL)
+      if (addToken(psLexer, aeSpecial[ucClass], 0, 0) == FALSE)
+        return LEX_NOMEM;
+    if (psTrans->ucAction & LA_QERROR)
+      return LEX_QERROR;
+    if (psTrans->ucAction & LA_DONE)
+      return finishLine(psLexer);
+    if (psTrans->ucAction & LA_BEGIN)
+      psLexer->iValueStart = CharVec_size(&psLexer->psLine->sBuf);
+
+    eState = (enum LexerState)psTrans->ucNext;
+
+    if (psTrans->ucAction & LA_APPEND) {
+      /* Append this byte and the rest of its run at once. */
+      uSpan = appendSpan(psLexer->iMode, eState, pcChunk + uIndex,
+                         uLength - uIndex);
+      assert(uSpan > 0);
+      if (appendValue(psLexer, pcChunk + uIndex, uSpan) == FALSE)
+        return LEX_NOMEM;
+      uIndex += uSpan;
     }
+    else
+      uIndex++;
   }
 
-  return ret;
+  psLexer->iState = eState;
+  return LEX_MORE;
 }
 
+/*--------------------------------------------------------------------*/
+
+enum LexResult
+Lexer_finish(struct Lexer *psLexer) {
+
+  /* The input ended before the line did.  Treat that as the end of
+     the line and return the final result. */
+
+  return Lexer_feed(psLexer, "", 1);
+}
@@ -1,13 +1,11 @@
 #ifndef _LEXSYN_H_
 #define _LEXSYN_H_
 
+#include <stddef.h>
 #include "dynarray.h"
+#include "token.h"
 
-enum {MAX_LINE_SIZE = 1024};
-enum {MAX_ARGS_CNT = 64};
-
-enum LexResult {LEX_SUCCESS, LEX_QERROR, LEX_NOMEM, LEX_LONG};
-enum AliasResult {ALIAS_SUCCESS, ALIAS_LONG, ALIAS_QERROR};
+enum LexResult {LEX_SUCCESS, LEX_QERROR, LEX_NOMEM, LEX_MORE};
 enum SyntaxResult {
   SYN_SUCCESS,
   SYN_FAIL_NOCMD,
@@ -18,10 +16,37 @@ enum SyntaxResult {
   SYN_FAIL_INVALIDBG,
 };
 
-void command_lexLine(const char * pcLine, DynArray_T ctokens);
-enum AliasResult alias_lexLine(const char *pcLine, DynArray_T oTokens);
-enum LexResult lexLine_quote(const char *pcLine, DynArray_T oTokens);
-enum LexResult lexLine(const char *pcLine, DynArray_T oTokens);
-enum SyntaxResult syntaxCheck(DynArray_T oTokens);
+/* How a Lexer splits a line into tokens. */
+enum LexMode {
+  LEXMODE_SHELL,   /* command lines: words, quotes, | < > & */
+  LEXMODE_WORDS,   /* whitespace separated words with quotes */
+  LEXMODE_RAW,     /* whitespace separated words, quotes are literal */
+  LEXMODE_ALIAS,   /* alias definitions: NAME=VALUE */
+  LEXMODE_COUNT
+};
+
+struct Pipeline;
+
+/* A Lexer keeps the lexer's state between calls to Lexer_feed(), so a
+   line can arrive in chunks of any size. */
+struct Lexer {
+  /* The enum LexMode in use, and the DFA state. */
+  int iMode;
+  int iState;
+
+  /* Offset in psLine->sBuf of the value of the word being lexed. */
+  int iValueStart;
+
+  /* The TokenLine receiving the tokens, and the Pipeline parsing them
+     as they are made, or NULL. */
+  struct TokenLine *psLine;
+  struct Pipeline *psPipeline;
+};
+
+int Lexer_init(struct Lexer *psLexer, struct TokenLine *psLine,
+               enum LexMode eMode, struct Pipeline *psPipeline);
+enum LexResult Lexer_feed(struct Lexer *psLexer, const char *pcChunk,
+                          size_t uLength);
+enum LexResult Lexer_finish(struct Lexer *psLexer);
 
 #endif /* _LEXSYN_H_ */
@@ -0,0 +1,200 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parsecache.h"
+#include "util.h"
+
+/*--------------------------------------------------------------------*/
+/* The parse cache maps the bytes of a command line to its TokenLine
+   and Pipeline, so a line that was run before skips lexing and the
+   syntax check.  It holds at most PARSECACHE_SIZE lines and drops the
+   least recently used one when full.  Lookup hashes the line, then
+   compares it in full against the entries in its bucket. */
+
+enum {BUCKET_COUNT = 2 * PARSECACHE_SIZE};
+
+static struct CacheEntry *apsBuckets[BUCKET_COUNT];
+
+/* The recently-used list: psHead is the most recent entry. */
+static struct CacheEntry *psHead = NULL;
+static struct CacheEntry *psTail = NULL;
+static int iEntries = 0;
+
+/* Entries made before the last ParseCache_invalidate() are stale. */
+static unsigned long ulGeneration = 0;
+
+static long lHits = 0;
+static long lMisses = 0;
+
+/*--------------------------------------------------------------------*/
+
+static unsigned long
+hashLine(const char *pcLine, size_t uLength) {
+  /* FNV-1a */
+  unsigned long ulHash = 2166136261UL;
+  size_t u;
+
+  for (u = 0; u < uLength; u++) {
+    ulHash ^= (unsigned char)pcLine[u];
+    ulHash *= 16777619UL;
+  }
+  return ulHash;
+}
+
+static void
+unlinkEntry(struct CacheEntry *psEntry) {
+  /* Take psEntry off the recently-used list. */
+  if (psEntry->psPrev != NULL)
+    psEntry->psPrev->psNext = psEntry->psNext;
+  else
+    psHead = psEntry->psNext;
+  if (psEntry->psNext != NULL)
+    psEntry->psNext->psPrev = psEntry->psPrev;
+  else
+    psTail = psEntry->psPrev;
+}
+
+static void
+pushFront(struct CacheEntry *psEntry) {
+  /* Make psEntry the most recently used entry. */
+  psEntry->psPrev = NULL;
+  psEntry->psNext = psHead;
+  if (psHead != NULL)
+    psHead->psPrev = psEntry;
+  psHead = psEntry;
+  if (psTail == NULL)
+    psTail = psEntry;
+}
+
+static void
+removeEntry(struct CacheEntry *psEntry) {
+  /* Remove psEntry from the cache and free it. */
+  struct CacheEntry **ppsLink;
+
+  ppsLink = &apsBuckets[psEntry->ulHash % BUCKET_COUNT];
+  while (*ppsLink != psEntry)
+    ppsLink = &(*ppsLink)->psChain;
+  *ppsLink = psEntry->psChain;
+  unlinkEntry(psEntry);
+  iEntries--;
+
+  Pipeline_free(&psEntry->sPipeline);
+  TokenLine_free(&psEntry->sLine);
+  free(psEntry->pcKey);
+  free(psEntry);
+}
+
+/*--------------------------------------------------------------------*/
+
+const struct CacheEntry *
+ParseCache_lookup(const char *pcLine, size_t uLength) {
+
+  /* Return the cached parse of the uLength bytes at pcLine, or NULL if
+     there is none. */
+
+  struct CacheEntry *psEntry;
+  unsigned long ulHash;
+
+  assert(pcLine != NULL);
+
+  ulHash = hashLine(pcLine, uLength);
+  for (psEntry = apsBuckets[ulHash % BUCKET_COUNT]; psEntry != NULL;
+       psEntry = psEntry->psChain) {
+    if ((psEntry->ulHash == ulHash) &&
+        (psEntry->uKeyLength == uLength) &&
+        (memcmp(psEntry->pcKey, pcLine, uLength) == 0))
+      break;
+  }
+
+  if ((psEntry != NULL) && (psEntry->ulGeneration != ulGeneration)) {
+    removeEntry(psEntry);
+    psEntry = NULL;
+  }
+  if (psEntry == NULL) {
+    lMisses++;
+    return NULL;
+  }
+
+  lHits++;
+  unlinkEntry(psEntry);
+  pushFront(psEntry);
+  return psEntry;
+}
+
+/*--------------------------------------------------------------------*/
+
+const struct CacheEntry *
+ParseCache_insert(const char *pcLine, size_t uLength,
+    struct TokenLine *psLine, struct Pipeline *psPipeline) {
+
+  /* Cache psLine and psPipeline as the parse of the uLength bytes at
+     pcLine, which must not be cached already, and return the new
+     entry.  The cache takes over what psLine and psPipeline own.
+     Return NULL if insufficient memory is available, in which case the
+     caller keeps them. */
+
+  struct CacheEntry *psEntry;
+
+  assert(pcLine != NULL);
+  assert(psLine != NULL);
+  assert(psPipeline != NULL);
+
+  psEntry = (struct CacheEntry*)malloc(sizeof(struct CacheEntry));
+  if (psEntry == NULL)
+    return NULL;
+  psEntry->pcKey = (char*)malloc(uLength + 1);
+  if (psEntry->pcKey == NULL) {
+    free(psEntry);
+    return NULL;
+  }
+  memcpy(psEntry->pcKey, pcLine, uLength);
+  psEntry->pcKey[uLength] = '\0';
+  psEntry->uKeyLength = uLength;
+  psEntry->ulHash = hashLine(pcLine, uLength);
+  psEntry->ulGeneration = ulGeneration;
+  psEntry->sLine = *psLine;
+  psEntry->sPipeline = *psPipeline;
+
+  if (iEntries == PARSECACHE_SIZE)
+    removeEntry(psTail);
+
+  psEntry->psChain = apsBuckets[psEntry->ulHash % BUCKET_COUNT];
+  apsBuckets[psEntry->ulHash % BUCKET_COUNT] = psEntry;
+  pushFront(psEntry);
+  iEntries++;
+  return psEntry;
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+ParseCache_invalidate(void) {
+
+  /* Forget every cached line, e.g. because alias definitions changed.
+     Entries are freed when next looked up or evicted, so one that is
+     still being run stays valid. */
+
+  ulGeneration++;
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+ParseCache_getStats(long *plHits, long *plMisses) {
+
+  /* Store the number of lookups that hit and missed so far. */
+
+  *plHits = lHits;
+  *plMisses = lMisses;
+}
+
+void
+ParseCache_dumpStats(void) {
+
+  /* Print the hit and miss counts when DEBUG is set. */
+
+  if (getenv("DEBUG") != NULL)
+    fprintf(stderr, "[parse cache] %ld hits, %ld misses\n",
+            lHits, lMisses);
+}
@@ -0,0 +1,42 @@
+#ifndef _PARSECACHE_H_
+#define _PARSECACHE_H_
+
+#include <stddef.h>
+#include "pipeline.h"
+#include "token.h"
+
+enum {PARSECACHE_SIZE = 64};
+
+/* A parsed line kept by the parse cache.  The cache owns it; callers
+   must not change or free sLine or sPipeline. */
+struct CacheEntry {
+  /* The line's bytes, their length and hash. */
+  char *pcKey;
+  size_t uKeyLength;
+  unsigned long ulHash;
+
+  /* The cache generation the entry was made in. */
+  unsigned long ulGeneration;
+
+  /* The tokens and the parsed form of the line. */
+  struct TokenLine sLine;
+  struct Pipeline sPipeline;
+
+  /* Neighbours in the recently-used list, and the next entry in the
+     same hash bucket. */
+  struct CacheEntry *psPrev;
+  struct CacheEntry *psNext;
+  struct CacheEntry *psChain;
+};
+
+const struct CacheEntry *ParseCache_lookup(const char *pcLine,
+                                           size_t uLength);
+const struct CacheEntry *ParseCache_insert(const char *pcLine,
+                                           size_t uLength,
+                                           struct TokenLine *psLine,
+                                           struct Pipeline *psPipeline);
+void ParseCache_invalidate(void);
+void ParseCache_getStats(long *plHits, long *plMisses);
+void ParseCache_dumpStats(void);
+
+#endif /* _PARSECACHE_H_ */
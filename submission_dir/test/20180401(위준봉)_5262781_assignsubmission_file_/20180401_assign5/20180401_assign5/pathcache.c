@@ -0,0 +1,271 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "arena.h"
+#include "pathcache.h"
+#include "symbol.h"
+
+/*--------------------------------------------------------------------*/
+/* The PATH cache maps a command name to the file that runs it, so
+   PATH is searched once per name rather than once per command.  The
+   cache is an array indexed by symbol id; a name is interned when it
+   is first searched for, so the lexer hands later commands of that
+   name over with their id.  A name that is in no PATH directory, a
+   typo mostly, is remembered as missing, so it is not searched for
+   again either.  Nothing is remembered for a search that went through
+   a relative PATH directory such as "." or an empty entry, since its
+   answer depends on the working directory; that answer is copied into
+   the caller's arena instead.  Everything is dropped when PATH
+   changes, or by the rehash builtin. */
+
+/* What the cache knows about a name. */
+enum PathState {PATH_UNKNOWN, PATH_FOUND, PATH_MISSING};
+
+struct PathEntry {
+  enum PathState eState;
+
+  /* The file, if eState is PATH_FOUND. */
+  const char *pcPath;
+
+  /* The number of times the entry has been used. */
+  long lHits;
+};
+
+/* Used when PATH is not set, as execvp() does. */
+static const char acDefaultPath[] = "/bin:/usr/bin";
+
+static struct PathEntry *psEntries = NULL;
+static int iPhysEntries = 0;
+
+/* The paths of the entries.  Freed all at once by PathCache_clear(). */
+static Arena_T oPaths = NULL;
+
+/*--------------------------------------------------------------------*/
+
+static struct PathEntry *
+entryOf(int iSymbol) {
+  /* Return the entry for symbol iSymbol, making room for it if needed,
+     or NULL if insufficient memory is available. */
+  struct PathEntry *psGrown;
+  int iPhys;
+
+  if (iSymbol >= iPhysEntries) {
+    iPhys = (iPhysEntries == 0) ? 64 : iPhysEntries;
+    while (iPhys <= iSymbol)
+      iPhys *= 2;
+    psGrown = (struct PathEntry*)realloc(psEntries,
+        sizeof(struct PathEntry) * (size_t)iPhys);
+    if (psGrown == NULL)
+      return NULL;
+    memset(psGrown + iPhysEntries, 0,
+           sizeof(struct PathEntry) * (size_t)(iPhys - iPhysEntries));
+    psEntries = psGrown;
+    iPhysEntries = iPhys;
+  }
+  return &psEntries[iSymbol];
+}
+
+static char *
+searchPath(const char *pcName, int *piVolatile) {
+  /* Return the first executable regular file named pcName in a PATH
+     directory, allocated with malloc(), or NULL if there is none.  Set
+     *piVolatile if the answer must not be remembered: a relative
+     directory was searched, so a cd could change it, or there was not
+     enough memory to finish the search. */
+  const char *pcPath = getenv("PATH");
+  const char *pcDir;
+  const char *pcEnd;
+  size_t uDir, uName = strlen(pcName);
+  struct stat sStat;
+  char *pcFile;
+
+  if (pcPath == NULL)
+    pcPath = acDefaultPath;
+
+  for (pcDir = pcPath; ; pcDir = pcEnd + 1) {
+    pcEnd = strchr(pcDir, ':');
+    if (pcEnd == NULL)
+      pcEnd = pcDir + strlen(pcDir);
+    uDir = (size_t)(pcEnd - pcDir);
+
+    /* An empty directory is the working directory. */
+    pcFile = malloc(uDir + uName + 3);
+    if (pcFile == NULL) {
+      *piVolatile = 1;
+      return NULL;
+    }
+    if (uDir == 0)
+      strcpy(pcFile, ".");
+    else {
+      memcpy(pcFile, pcDir, uDir);
+      pcFile[uDir] = '\0';
+    }
+    strcat(pcFile, "/");
+    strcat(pcFile, pcName);
+    if (pcFile[0] != '/')
+      *piVolatile = 1;
+
+    if ((stat(pcFile, &sStat) == 0) && S_ISREG(sStat.st_mode) &&
+        (access(pcFile, X_OK) == 0))
+      return pcFile;
+    free(pcFile);
+
+    if (*pcEnd == '\0')
+      return NULL;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static char *
+copyPath(Arena_T oArena, const char *pcFile) {
+  /* Return a copy of pcFile in oArena, or NULL if oArena is NULL or
+     insufficient memory is available. */
+  char *pcCopy;
+
+  if (oArena == NULL)
+    return NULL;
+  pcCopy = Arena_alloc(oArena, strlen(pcFile) + 1);
+  if (pcCopy != NULL)
+    strcpy(pcCopy, pcFile);
+  return pcCopy;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *
+PathCache_resolve(const char *pcName, int iSymbol, Arena_T oArena) {
+
+  /* Return the file to execute for command pcName, or NULL if PATH has
+     none.  A name with a '/' in it is the file itself.  iSymbol is the
+     symbol id of pcName, or SYMBOL_NONE if the caller does not know
+     it.  An answer the cache keeps is valid until the cache is cleared
+     or pcName forgotten.  One it cannot keep is copied into oArena and
+     lives as long as oArena does; NULL is returned if there is not
+     enough memory for the copy.
+     It is a checked runtime error for oArena to be NULL. */
+
+  struct PathEntry *psEntry = NULL;
+  const char *pcPath;
+  char *pcFile;
+  int iVolatile = 0;
+
+  assert(pcName != NULL);
+  assert(oArena != NULL);
+  assert((iSymbol == SYMBOL_NONE) ||
+         (strcmp(Symbol_name(iSymbol), pcName) == 0));
+
+  if (strchr(pcName, '/') != NULL)
+    return pcName;
+  if (pcName[0] == '\0')
+    return NULL;
+
+  if (iSymbol == SYMBOL_NONE)
+    iSymbol = Symbol_find(pcName);
+  if (iSymbol != SYMBOL_NONE)
+    psEntry = entryOf(iSymbol);
+  if (psEntry != NULL && psEntry->eState != PATH_UNKNOWN) {
+    psEntry->lHits++;
+    return psEntry->pcPath;
+  }
+
+  pcFile = searchPath(pcName, &iVolatile);
+  if (psEntry == NULL && !iVolatile) {
+    /* intern the name, found or not, so the answer can be remembered */
+    iSymbol = Symbol_intern(pcName);
+    if (iSymbol != SYMBOL_NONE)
+      psEntry = entryOf(iSymbol);
+  }
+
+  if (psEntry != NULL && !iVolatile) {
+    psEntry->lHits = 1;
+    if (pcFile == NULL) {
+      psEntry->eState = PATH_MISSING;
+      psEntry->pcPath = NULL;
+      return NULL;
+    }
+    if (oPaths == NULL)
+      oPaths = Arena_new();
+    psEntry->pcPath = copyPath(oPaths, pcFile);
+    if (psEntry->pcPath != NULL) {
+      psEntry->eState = PATH_FOUND;
+      free(pcFile);
+      return psEntry->pcPath;
+    }
+  }
+
+  /* Not remembered: no memory for an entry, or the answer would go
+     stale on cd or was cut short by a lack of memory. */
+  if (pcFile == NULL)
+    return NULL;
+  pcPath = copyPath(oArena, pcFile);
+  free(pcFile);
+  return pcPath;
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+PathCache_isCached(const char *pcName) {
+
+  /* Return TRUE (1) iff the cache has an answer for pcName. */
+
+  int iSymbol = Symbol_find(pcName);
+
+  return (iSymbol != SYMBOL_NONE) && (iSymbol < iPhysEntries) &&
+         (psEntries[iSymbol].eState != PATH_UNKNOWN);
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+PathCache_forget(const char *pcName) {
+
+  /* Drop what the cache knows about pcName, as when its file has gone
+     away.  Its path stays in the arena until the next clear. */
+
+  int iSymbol = Symbol_find(pcName);
+
+  if ((iSymbol != SYMBOL_NONE) && (iSymbol < iPhysEntries)) {
+    psEntries[iSymbol].eState = PATH_UNKNOWN;
+    psEntries[iSymbol].pcPath = NULL;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+PathCache_clear(void) {
+
+  /* Forget every name, as when PATH changes. */
+
+  if (psEntries != NULL)
+    memset(psEntries, 0, sizeof(struct PathEntry) * (size_t)iPhysEntries);
+  Arena_free(oPaths);
+  oPaths = NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+PathCache_print(FILE *fp) {
+
+  /* Print the names found in PATH, with their hit counts, in the
+     format of the hash builtin of sh. */
+
+  int iPrinted = 0;
+  int i;
+
+  for (i = 0; i < iPhysEntries; i++) {
+    if (psEntries[i].eState != PATH_FOUND)
+      continue;
+    if (iPrinted++ == 0)
+      fprintf(fp, "hits\tcommand\n");
+    fprintf(fp, "%4ld\t%s\n", psEntries[i].lHits, psEntries[i].pcPath);
+  }
+  if (iPrinted == 0)
+    fprintf(fp, "hash: hash table empty\n");
+}
@@ -0,0 +1,14 @@
+#ifndef _PATHCACHE_H_
+#define _PATHCACHE_H_
+
+#include <stdio.h>
+#include "arena.h"
+
+const char *PathCache_resolve(const char *pcName, int iSymbol,
+                              Arena_T oArena);
+int PathCache_isCached(const char *pcName);
+void PathCache_forget(const char *pcName);
+void PathCache_clear(void);
+void PathCache_print(FILE *fp);
+
+#endif /* _PATHCACHE_H_ */
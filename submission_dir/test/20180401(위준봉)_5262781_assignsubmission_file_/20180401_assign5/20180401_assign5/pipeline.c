@@ -0,0 +1,228 @@
+#include <assert.h>
+#include "pipeline.h"
+#include "util.h"
+
+/* What the next WORD token is. */
+enum {EXPECT_ARG, EXPECT_REDIN, EXPECT_REDOUT};
+
+/*--------------------------------------------------------------------*/
+
+void
+Pipeline_init(struct Pipeline *psPipeline, Arena_T oArena) {
+
+  /* Make psPipeline an empty Pipeline, ready for the first token, that
+     allocates from oArena. */
+
+  assert(psPipeline != NULL);
+  assert(oArena != NULL);
+
+  psPipeline->oArena = oArena;
+  psPipeline->eSyntax = SYN_SUCCESS;
+  StageVec_init(&psPipeline->sStages, oArena);
+  IntVec_init(&psPipeline->sWords, oArena);
+  psPipeline->ppcArgv = NULL;
+  psPipeline->pcRedIn = NULL;
+  psPipeline->pcRedOut = NULL;
+  psPipeline->iRedIn = -1;
+  psPipeline->iRedOut = -1;
+  psPipeline->iBackground = FALSE;
+  psPipeline->iTokens = 0;
+  psPipeline->iExpect = EXPECT_ARG;
+  psPipeline->ePending = SYN_SUCCESS;
+  psPipeline->iPipeSeen = FALSE;
+  psPipeline->iRedInSeen = FALSE;
+  psPipeline->iRedOutSeen = FALSE;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int
+openStage(struct Pipeline *psPipeline) {
+
+  /* Start a new stage whose argv begins at the next word.  Return
+     FALSE if insufficient memory is available. */
+
+  struct Stage *psStage;
+
+  psStage = StageVec_push(&psPipeline->sStages);
+  if (psStage == NULL)
+    return FALSE;
+  psStage->iArgv = IntVec_size(&psPipeline->sWords);
+  psStage->iArgc = 0;
+  psStage->iSymbol = SYMBOL_NONE;
+  return TRUE;
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+Pipeline_addToken(struct Pipeline *psPipeline,
+    enum TokenType eTokenType) {
+
+  /* Parse the next token of the line, whose type is eTokenType.  This
+     is the shell's only statement of its grammar: a line starts with a
+     command name; '|' needs a command after it and no '>' before it;
+     '<' may appear once, not after a '|', and '>' once, each followed
+     by a file name; '&' must come last.  The first rule broken, in
+     token order, is the error reported.  A rule that looks at the
+     following token is settled when that token arrives.  Return FALSE
+     if insufficient memory is available. */
+
+  int iToken;
+  struct Stage *psStage;
+
+  assert(psPipeline != NULL);
+
+  iToken = psPipeline->iTokens++;
+  if (psPipeline->eSyntax != SYN_SUCCESS)
+    return TRUE;
+
+  /* Settle the rules that needed to see this token. */
+  if (psPipeline->ePending != SYN_SUCCESS) {
+    if (eTokenType != TOKEN_WORD) {
+      psPipeline->eSyntax = psPipeline->ePending;
+      return TRUE;
+    }
+    psPipeline->ePending = SYN_SUCCESS;
+  }
+  if (psPipeline->iBackground) {
+    /* '&' must be the last token. */
+    psPipeline->eSyntax = SYN_FAIL_INVALIDBG;
+    return TRUE;
+  }
+  if ((iToken == 0) && (eTokenType != TOKEN_WORD)) {
+    /* Missing command name */
+    psPipeline->eSyntax = SYN_FAIL_NOCMD;
+    return TRUE;
+  }
+
+  switch (eTokenType) {
+    case TOKEN_WORD:
+      if (psPipeline->iExpect == EXPECT_REDIN)
+        psPipeline->iRedIn = iToken;
+      else if (psPipeline->iExpect == EXPECT_REDOUT)
+        psPipeline->iRedOut = iToken;
+      else {
+        if ((StageVec_size(&psPipeline->sStages) == 0) ||
+            (*IntVec_at(&psPipeline->sWords,
+                        IntVec_size(&psPipeline->sWords) - 1) == -1))
+          if (openStage(psPipeline) == FALSE)
+            return FALSE;
+        if (IntVec_add(&psPipeline->sWords, iToken) == FALSE)
+          return FALSE;
+        psStage = StageVec_at(&psPipeline->sStages,
+                              StageVec_size(&psPipeline->sStages) - 1);
+        psStage->iArgc++;
+      }
+      psPipeline->iExpect = EXPECT_ARG;
+      break;
+
+    case TOKEN_PIPE:
+      /* No redout in previous tokens and a command must follow */
+      if (psPipeline->iRedOutSeen) {
+        psPipeline->eSyntax = SYN_FAIL_MULTREDOUT;
+        break;
+      }
+      if (IntVec_add(&psPipeline->sWords, -1) == FALSE)
+        return FALSE;
+      psPipeline->ePending = SYN_FAIL_NOCMD;
+      psPipeline->iPipeSeen = TRUE;
+      break;
+
+    case TOKEN_BG:
+      psPipeline->iBackground = TRUE;
+      break;
+
+    case TOKEN_REDIN:
+      /* No pipe in previous tokens and no redin in following tokens */
+      if (psPipeline->iPipeSeen || psPipeline->iRedInSeen) {
+        psPipeline->eSyntax = SYN_FAIL_MULTREDIN;
+        break;
+      }
+      psPipeline->ePending = SYN_FAIL_NODESTIN;
+      psPipeline->iExpect = EXPECT_REDIN;
+      psPipeline->iRedInSeen = TRUE;
+      break;
+
+    case TOKEN_REDOUT:
+      /* No redout in following tokens */
+      if (psPipeline->iRedOutSeen) {
+        psPipeline->eSyntax = SYN_FAIL_MULTREDOUT;
+        break;
+      }
+      psPipeline->ePending = SYN_FAIL_NODESTOUT;
+      psPipeline->iExpect = EXPECT_REDOUT;
+      psPipeline->iRedOutSeen = TRUE;
+      break;
+
+    default:
+      assert(FALSE);
+  }
+  return TRUE;
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+Pipeline_finish(struct Pipeline *psPipeline, struct TokenLine *psLine) {
+
+  /* The line has ended and psLine holds its finished tokens.  Settle
+     the pending syntax rule and build the argument vectors.  Return
+     FALSE if insufficient memory is available. */
+
+  struct Token *psTokens;
+  struct Stage *psStage;
+  int *piWords;
+  int iWords;
+  int i;
+
+  assert(psPipeline != NULL);
+  assert(psLine != NULL);
+
+  if ((psPipeline->eSyntax == SYN_SUCCESS) &&
+      (psPipeline->ePending != SYN_SUCCESS))
+    psPipeline->eSyntax = psPipeline->ePending;
+  if ((psPipeline->eSyntax != SYN_SUCCESS) || (psPipeline->iTokens == 0))
+    return TRUE;
+
+  if (IntVec_add(&psPipeline->sWords, -1) == FALSE)
+    return FALSE;
+  iWords = IntVec_size(&psPipeline->sWords);
+  piWords = IntVec_data(&psPipeline->sWords);
+  psTokens = TokenVec_data(&psLine->sTokens);
+  psPipeline->ppcArgv = (char**)Arena_alloc(psPipeline->oArena,
+      sizeof(char*) * (size_t)iWords);
+  if (psPipeline->ppcArgv == NULL)
+    return FALSE;
+  for (i = 0; i < iWords; i++) {
+    if (piWords[i] < 0)
+      psPipeline->ppcArgv[i] = NULL;
+    else
+      psPipeline->ppcArgv[i] = psTokens[piWords[i]].pcValue;
+  }
+
+  for (i = 0; i < StageVec_size(&psPipeline->sStages); i++) {
+    psStage = StageVec_at(&psPipeline->sStages, i);
+    psStage->iSymbol = psTokens[piWords[psStage->iArgv]].iSymbol;
+  }
+
+  if (psPipeline->iRedIn >= 0)
+    psPipeline->pcRedIn = psTokens[psPipeline->iRedIn].pcValue;
+  if (psPipeline->iRedOut >= 0)
+    psPipeline->pcRedOut = psTokens[psPipeline->iRedOut].pcValue;
+  return TRUE;
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+Pipeline_free(struct Pipeline *psPipeline) {
+
+  /* Forget what psPipeline holds.  Its storage belongs to the arena,
+     which is freed with the TokenLine. */
+
+  psPipeline->oArena = NULL;
+  StageVec_init(&psPipeline->sStages, NULL);
+  IntVec_init(&psPipeline->sWords, NULL);
+  psPipeline->ppcArgv = NULL;
+}
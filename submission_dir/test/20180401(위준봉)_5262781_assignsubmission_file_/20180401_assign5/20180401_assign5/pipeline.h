@@ -0,0 +1,73 @@
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include "arena.h"
+#include "dynvec.h"
+#include "lexsyn.h"
+#include "token.h"
+
+/* One stage of a pipeline. */
+struct Stage {
+  /* The stage's argument vector is ppcArgv + iArgv in the Pipeline.
+     It holds iArgc words followed by NULL. */
+  int iArgv;
+  int iArgc;
+
+  /* The symbol id of the command name, argv[0], as the lexer found it:
+     SYMBOL_NONE if the name was not interned yet. */
+  int iSymbol;
+};
+
+DYNARRAY_DEFINE(StageVec, struct Stage)
+DYNARRAY_DEFINE(IntVec, int)
+
+/* A Pipeline is the parsed form of a command line.  The lexer hands it
+   each token as soon as the token is made, so the syntax check and the
+   split into stages happen in the same pass as lexing. */
+struct Pipeline {
+  /* The arena everything below is allocated from, shared with the
+     TokenLine of the same line. */
+  Arena_T oArena;
+
+  /* The result of the syntax check. */
+  enum SyntaxResult eSyntax;
+
+  /* The stages, in order. */
+  struct StageVec sStages;
+
+  /* The token index of every argv word, with -1 after each stage's
+     last word.  Pipeline_finish() turns this into ppcArgv. */
+  struct IntVec sWords;
+
+  /* The argument vectors of all stages, back to back. */
+  char **ppcArgv;
+
+  /* The redirection targets, or NULL, and their token indices, or
+     -1. */
+  char *pcRedIn;
+  char *pcRedOut;
+  int iRedIn;
+  int iRedOut;
+
+  /* TRUE (1) if the line ends with '&'. */
+  int iBackground;
+
+  /* Parser state: the number of tokens seen, what the next WORD is,
+     the error to report if the next token is not a WORD, and which
+     special tokens have been seen. */
+  int iTokens;
+  int iExpect;
+  enum SyntaxResult ePending;
+  int iPipeSeen;
+  int iRedInSeen;
+  int iRedOutSeen;
+};
+
+void Pipeline_init(struct Pipeline *psPipeline, Arena_T oArena);
+int Pipeline_addToken(struct Pipeline *psPipeline,
+                      enum TokenType eTokenType);
+int Pipeline_finish(struct Pipeline *psPipeline,
+                    struct TokenLine *psLine);
+void Pipeline_free(struct Pipeline *psPipeline);
+
+#endif /* _PIPELINE_H_ */
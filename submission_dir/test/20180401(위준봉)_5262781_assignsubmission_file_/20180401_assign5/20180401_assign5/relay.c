@@ -0,0 +1,221 @@
+#define _GNU_SOURCE /* F_SETPIPE_SZ, splice, tee */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "launch.h"
+#include "pathcache.h"
+#include "relay.h"
+#include "util.h"
+
+/*--------------------------------------------------------------------*/
+/* relay.c                                                            */
+/* High-throughput pipe modes.  ISH_PIPE_SIZE grows every pipe of a   */
+/* pipeline with F_SETPIPE_SZ, to the given number of bytes or, for   */
+/* "max", to /proc/sys/fs/pipe-max-size, so that stages block on each */
+/* other less often; it changes nothing else.  ISH_RELAY=1, a         */
+/* separate opt-in, has the shell run a stage that only passes its    */
+/* input on, "cat" with no operands or "tee" with one file, between   */
+/* two pipes as a relay: splice() and tee() move the data from pipe   */
+/* to pipe inside the kernel, never copying it to user space.  A      */
+/* relay reports errors and exits as the shell's code does, not as    */
+/* the program it stands in for.  Only the system's own cat and tee   */
+/* are replaced; one found elsewhere in PATH runs as usual.           */
+/*--------------------------------------------------------------------*/
+
+#define PIPE_MAX_SIZE_FILE "/proc/sys/fs/pipe-max-size"
+
+static int pipe_max_size(void) {
+  /* return the largest pipe an unprivileged process may ask for, or 0
+   * if it cannot be read
+   */
+  FILE *fp;
+  long max = 0;
+
+  if ((fp = fopen(PIPE_MAX_SIZE_FILE, "r")) == NULL)
+    return 0;
+  if (fscanf(fp, "%ld", &max) != 1 || max < 0 || max > INT_MAX)
+    max = 0;
+  fclose(fp);
+  return (int)max;
+}
+
+int relay_pipe_size(void) {
+  /* return the pipe size selected by ISH_PIPE_SIZE, never above the
+   * system maximum, or 0 if the mode is off
+   */
+  const char *value = getenv("ISH_PIPE_SIZE");
+  char *end;
+  long size;
+  int max;
+
+  if (value == NULL || *value == '\0')
+    return 0;
+  if ((max = pipe_max_size()) <= 0)
+    return 0;
+  if (strcmp(value, "max") == 0)
+    return max;
+  errno = 0;
+  size = strtol(value, &end, 10);
+  if (errno != 0 || *end != '\0' || size <= 0)
+    return 0;
+  return size < max ? (int)size : max;
+}
+
+void relay_size_pipe(int fd, int size) {
+  /* grow the pipe fd to size bytes; the kernel rounds it up to a power
+   * of two pages.  Failure, e.g. when the user is over the pipe quota
+   * of /proc/sys/fs/pipe-user-pages-soft, just leaves the pipe as it
+   * is
+   * @fd: either end of the pipe
+   * @size: bytes, as returned by relay_pipe_size()
+   */
+  assert(fd >= 0 && size > 0);
+
+  fcntl(fd, F_SETPIPE_SZ, size);
+}
+
+static int is_system_tool(const char *name, int symbol) {
+  /* return TRUE if PATH runs name from /bin or /usr/bin */
+  static const char *const dirs[] = {"/bin/", "/usr/bin/"};
+  Arena_T paths;
+  const char *path;
+  size_t i, len;
+  int found = FALSE;
+
+  if ((paths = Arena_new()) == NULL)
+    return FALSE;
+  path = PathCache_resolve(name, symbol, paths);
+  for (i = 0; path != NULL && i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+    len = strlen(dirs[i]);
+    if (strncmp(path, dirs[i], len) == 0 && strcmp(path + len, name) == 0)
+      found = TRUE;
+  }
+  Arena_free(paths);
+  return found;
+}
+
+int relay_enabled(void) {
+  /* return TRUE if ISH_RELAY selects relays for pass-through stages */
+  const char *value = getenv("ISH_RELAY");
+
+  return value != NULL && strcmp(value, "1") == 0;
+}
+
+int relay_stage(int argc, char **argv, int symbol) {
+  /* return TRUE if the stage argc, argv only passes its input on and
+   * can be run as a relay: the system's "cat" with no operands, or its
+   * "tee" with exactly one file and no options
+   * @symbol: symbol id of argv[0], or SYMBOL_NONE
+   */
+  assert(argv != NULL);
+
+  if (strcmp(argv[0], "cat") == 0 && argc == 1)
+    return is_system_tool(argv[0], symbol);
+  if (strcmp(argv[0], "tee") == 0 && argc == 2 && argv[1][0] != '-')
+    return is_system_tool(argv[0], symbol);
+  return FALSE;
+}
+
+static ssize_t move_some(int fd_in, int fd_out, size_t len, int *copy) {
+  /* move up to len bytes from the pipe fd_in to fd_out with splice().
+   * A target without splice support, such as a tty or some FUSE and
+   * /proc files, fails with EINVAL; from then on *copy is set and the
+   * bytes go through read() and write() instead
+   * return the number of bytes moved, 0 at EOF, or -1 with errno set
+   */
+  static char buf[65536];
+  ssize_t n, w, done;
+
+  if (!*copy) {
+    n = splice(fd_in, NULL, fd_out, NULL, len, SPLICE_F_MOVE | SPLICE_F_MORE);
+    if (n >= 0 || errno != EINVAL)
+      return n;
+    *copy = TRUE;
+  }
+  if (len > sizeof(buf))
+    len = sizeof(buf);
+  if ((n = read(fd_in, buf, len)) <= 0)
+    return n;
+  for (done = 0; done < n; done += w)
+    if ((w = write(fd_out, buf + done, (size_t)(n - done))) < 0) {
+      if (errno != EINTR)
+        return -1;
+      w = 0;
+    }
+  return n;
+}
+
+static int move_all(int fd_in, int fd_out, size_t len, int *copy) {
+  /* move exactly len bytes from the pipe fd_in to fd_out, as move_some
+   * does
+   * return FALSE after reporting the error if it cannot be done
+   */
+  ssize_t n;
+
+  while (len > 0) {
+    n = move_some(fd_in, fd_out, len, copy);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      errorPrint(strerror(n < 0 ? errno : EIO), FPRINTF);
+      return FALSE;
+    }
+    len -= (size_t)n;
+  }
+  return TRUE;
+}
+
+int relay_run(int argc, char *argv[]) {
+  /* relay stdin to stdout, both pipes, until the writer is done; for
+   * tee also to the file argv[1], which is created or truncated.  Runs
+   * in a forked child of the shell.
+   * return the exit status of the stage
+   */
+  size_t chunk;
+  ssize_t n;
+  int fd = -1, size;
+  int copy_out = FALSE, copy_file = FALSE;
+
+  assert(argc == 1 || argc == 2);
+
+  if (argc == 2 &&
+      (fd = open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0) {
+    errorPrint(argv[1], PERROR);
+    return EXIT_FAILURE;
+  }
+  size = fcntl(FD_IN, F_GETPIPE_SZ);
+  chunk = size > 0 ? (size_t)size : 65536;
+
+  for (;;) {
+    /* tee() copies the buffered data to stdout by reference and leaves
+     * it in stdin, to be spliced to the file; cat splices it straight
+     * through */
+    if (fd >= 0)
+      n = tee(FD_IN, FD_OUT, chunk, 0);
+    else
+      n = move_some(FD_IN, FD_OUT, chunk, &copy_out);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      errorPrint(strerror(errno), FPRINTF);
+      break;
+    }
+    if (n == 0) {
+      /* EOF */
+      if (fd >= 0)
+        close(fd);
+      return EXIT_SUCCESS;
+    }
+    if (fd >= 0 && !move_all(FD_IN, fd, (size_t)n, &copy_file))
+      break;
+  }
+  if (fd >= 0)
+    close(fd);
+  return EXIT_FAILURE;
+}
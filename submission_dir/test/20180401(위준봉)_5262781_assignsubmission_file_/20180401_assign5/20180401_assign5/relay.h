@@ -0,0 +1,10 @@
+#ifndef _RELAY_H_
+#define _RELAY_H_
+
+int relay_pipe_size(void);
+void relay_size_pipe(int fd, int size);
+int relay_enabled(void);
+int relay_stage(int argc, char **argv, int symbol);
+int relay_run(int argc, char *argv[]);
+
+#endif /* _RELAY_H_ */
@@ -0,0 +1,242 @@
+/*--------------------------------------------------------------------*/
+/* symbol.c                                                           */
+/*--------------------------------------------------------------------*/
+
+#include "symbol.h"
+#include "arena.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The number of slots in the hash table when the first string is
+   added.  The table doubles when it is half full. */
+enum {MIN_SLOTS = 64};
+
+/*--------------------------------------------------------------------*/
+
+/* The table keeps the strings by id, and an open-addressing hash table
+   of ids, probed linearly, to find an id from its string. */
+
+static struct SymbolTable
+{
+  /* The strings and their hashes, by id, and the number of ids in use
+     and allocated. */
+  const char **ppcNames;
+  uint32_t *puHashes;
+  int iCount;
+  int iPhysCount;
+
+  /* The hash table: each slot holds an id, or SYMBOL_NONE.  iSlots is
+     a power of two. */
+  int *piSlots;
+  int iSlots;
+
+  /* Where the copies of the strings live.  They are never freed. */
+  Arena_T oArena;
+} sTable = {NULL, NULL, 0, 0, NULL, 0, NULL};
+
+/*--------------------------------------------------------------------*/
+
+static uint32_t Symbol_hash(const char *pc, size_t uLength)
+
+  /* Return the FNV-1a hash of the uLength bytes at pc. */
+
+{
+  uint32_t uHash = 2166136261u;
+  size_t u;
+
+  for (u = 0; u < uLength; u++)
+  {
+    uHash ^= (unsigned char)pc[u];
+    uHash *= 16777619u;
+  }
+  return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int *Symbol_probe(const char *pc, size_t uLength, uint32_t uHash)
+
+  /* Return the slot that holds the id of the uLength bytes at pc, whose
+     hash is uHash, or the empty slot where it belongs.  The table must
+     have slots. */
+
+{
+  unsigned int uMask = (unsigned int)sTable.iSlots - 1;
+  unsigned int u = uHash & uMask;
+  int iSymbol;
+
+  for (;;)
+  {
+    iSymbol = sTable.piSlots[u];
+    if (iSymbol == SYMBOL_NONE)
+      return &sTable.piSlots[u];
+    if ((sTable.puHashes[iSymbol] == uHash) &&
+        (strncmp(sTable.ppcNames[iSymbol], pc, uLength) == 0) &&
+        (sTable.ppcNames[iSymbol][uLength] == '\0'))
+      return &sTable.piSlots[u];
+    u = (u + 1) & uMask;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static int Symbol_growSlots(void)
+
+  /* Double the number of slots, or make the first MIN_SLOTS, and put
+     every id back.  Return 0 (FALSE) if insufficient memory is
+     available. */
+
+{
+  int iSlots = (sTable.iSlots == 0) ? MIN_SLOTS : sTable.iSlots * 2;
+  int *piSlots;
+  unsigned int u;
+  int i;
+
+  piSlots = (int*)malloc(sizeof(int) * (size_t)iSlots);
+  if (piSlots == NULL)
+    return 0;
+  for (i = 0; i < iSlots; i++)
+    piSlots[i] = SYMBOL_NONE;
+
+  for (i = 0; i < sTable.iCount; i++)
+  {
+    u = sTable.puHashes[i] & ((unsigned int)iSlots - 1);
+    while (piSlots[u] != SYMBOL_NONE)
+      u = (u + 1) & ((unsigned int)iSlots - 1);
+    piSlots[u] = i;
+  }
+
+  free(sTable.piSlots);
+  sTable.piSlots = piSlots;
+  sTable.iSlots = iSlots;
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+static int Symbol_growNames(void)
+
+  /* Double the room for ids.  Return 0 (FALSE) if insufficient memory
+     is available. */
+
+{
+  int iPhysCount = (sTable.iPhysCount == 0) ?
+    MIN_SLOTS / 2 : sTable.iPhysCount * 2;
+  const char **ppcNames;
+  uint32_t *puHashes;
+
+  ppcNames = (const char**)realloc(sTable.ppcNames,
+      sizeof(char*) * (size_t)iPhysCount);
+  if (ppcNames == NULL)
+    return 0;
+  sTable.ppcNames = ppcNames;
+  puHashes = (uint32_t*)realloc(sTable.puHashes,
+      sizeof(uint32_t) * (size_t)iPhysCount);
+  if (puHashes == NULL)
+    return 0;
+  sTable.puHashes = puHashes;
+  sTable.iPhysCount = iPhysCount;
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int Symbol_intern(const char *pcName)
+
+  /* Return the id of string pcName, adding a copy of it to the table
+     if it is not there yet.  Return SYMBOL_NONE if insufficient memory
+     is available.
+     It is a checked runtime error for pcName to be NULL. */
+
+{
+  size_t uLength;
+  uint32_t uHash;
+  int *piSlot;
+  char *pcCopy;
+
+  assert(pcName != NULL);
+
+  if (sTable.oArena == NULL)
+    if ((sTable.oArena = Arena_new()) == NULL)
+      return SYMBOL_NONE;
+  /* Keep the table at most half full, so probes stay short. */
+  if ((sTable.iCount + 1) * 2 > sTable.iSlots)
+    if (! Symbol_growSlots())
+      return SYMBOL_NONE;
+
+  uLength = strlen(pcName);
+  uHash = Symbol_hash(pcName, uLength);
+  piSlot = Symbol_probe(pcName, uLength, uHash);
+  if (*piSlot != SYMBOL_NONE)
+    return *piSlot;
+
+  if (sTable.iCount == sTable.iPhysCount)
+    if (! Symbol_growNames())
+      return SYMBOL_NONE;
+  pcCopy = (char*)Arena_alloc(sTable.oArena, uLength + 1);
+  if (pcCopy == NULL)
+    return SYMBOL_NONE;
+  memcpy(pcCopy, pcName, uLength + 1);
+
+  sTable.ppcNames[sTable.iCount] = pcCopy;
+  sTable.puHashes[sTable.iCount] = uHash;
+  *piSlot = sTable.iCount;
+  return sTable.iCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+int Symbol_find(const char *pcName)
+
+  /* Return the id of string pcName, or SYMBOL_NONE if it is not in the
+     table.
+     It is a checked runtime error for pcName to be NULL. */
+
+{
+  assert(pcName != NULL);
+
+  return Symbol_findLength(pcName, strlen(pcName));
+}
+
+/*--------------------------------------------------------------------*/
+
+int Symbol_findLength(const char *pcName, size_t uLength)
+
+  /* Return the id of the uLength bytes at pcName, or SYMBOL_NONE if
+     they are not in the table.
+     It is a checked runtime error for pcName to be NULL. */
+
+{
+  assert(pcName != NULL);
+
+  if (sTable.iCount == 0)
+    return SYMBOL_NONE;
+  return *Symbol_probe(pcName, uLength,
+                       Symbol_hash(pcName, uLength));
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *Symbol_name(int iSymbol)
+
+  /* Return the string whose id is iSymbol.
+     It is a checked runtime error for iSymbol not to be an id. */
+
+{
+  assert(iSymbol >= 0);
+  assert(iSymbol < sTable.iCount);
+
+  return sTable.ppcNames[iSymbol];
+}
+
+/*--------------------------------------------------------------------*/
+
+int Symbol_count(void)
+
+  /* Return the number of strings in the table. */
+
+{
+  return sTable.iCount;
+}
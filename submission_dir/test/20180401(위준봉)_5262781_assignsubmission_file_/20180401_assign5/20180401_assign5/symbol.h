@@ -0,0 +1,42 @@
+/*--------------------------------------------------------------------*/
+/* symbol.h                                                           */
+/*--------------------------------------------------------------------*/
+
+#ifndef SYMBOL_INCLUDED
+#define SYMBOL_INCLUDED
+
+#include <stddef.h>
+
+/* The symbol table interns strings: each distinct string added to it
+   gets a small integer id, 0, 1, 2, ... in order of arrival, that
+   stays the same for the life of the process.  Two strings are equal
+   iff their ids are, so code that has ids can compare names with one
+   integer compare and index tables by them.  The table is not safe to
+   use from several threads at once. */
+
+enum {SYMBOL_NONE = -1};
+
+int Symbol_intern(const char *pcName);
+/* Return the id of string pcName, adding a copy of it to the table if
+   it is not there yet.  Return SYMBOL_NONE if insufficient memory is
+   available.
+   It is a checked runtime error for pcName to be NULL. */
+
+int Symbol_find(const char *pcName);
+/* Return the id of string pcName, or SYMBOL_NONE if it is not in the
+   table.
+   It is a checked runtime error for pcName to be NULL. */
+
+int Symbol_findLength(const char *pcName, size_t uLength);
+/* Return the id of the uLength bytes at pcName, or SYMBOL_NONE if they
+   are not in the table.
+   It is a checked runtime error for pcName to be NULL. */
+
+const char *Symbol_name(int iSymbol);
+/* Return the string whose id is iSymbol.
+   It is a checked runtime error for iSymbol not to be an id. */
+
+int Symbol_count(void);
+/* Return the number of strings in the table. */
+
+#endif
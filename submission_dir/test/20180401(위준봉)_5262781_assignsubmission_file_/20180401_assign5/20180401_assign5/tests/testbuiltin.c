@@ -0,0 +1,282 @@
+/*--------------------------------------------------------------------*/
+/* testbuiltin.c                                                      */
+/* A test client for the in-process builtins: runs each case through  */
+/* the builtin and through the system's utility of the same name, and */
+/* compares their output and exit status.                             */
+/*--------------------------------------------------------------------*/
+
+#include "../builtin.h"
+#include "../util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+static int iFailures = 0;
+static int iCases = 0;
+
+enum {MAX_OUTPUT = 4096};
+
+/* Each case is the argument vector of one command, NULL-terminated,
+   checked at line __LINE__. */
+#define CASE(...) compare(__LINE__, (char *[]){__VA_ARGS__, NULL})
+
+/*--------------------------------------------------------------------*/
+
+static int run(const struct Builtin *psBuiltin, char *argv[],
+    char *pcOutput, size_t *puLength)
+
+  /* Run argv with the builtin psBuiltin if it is not NULL, and with
+     /usr/bin/argv[0] otherwise, in a child process whose stdout goes
+     to pcOutput, at most MAX_OUTPUT bytes, and whose stderr is
+     discarded.  Store the number of bytes written in *puLength.
+     Return the exit status of the child, or -1 if it did not exit. */
+
+{
+  char acPath[64];
+  int aiPipe[2];
+  int iStatus;
+  int iArgc;
+  ssize_t n;
+  pid_t pid;
+
+  if (pipe(aiPipe) < 0)
+  {
+    perror("pipe");
+    exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  pid = fork();
+  if (pid < 0)
+  {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0)
+  {
+    dup2(aiPipe[1], STDOUT_FILENO);
+    close(aiPipe[0]);
+    close(aiPipe[1]);
+    close(STDERR_FILENO);
+    open("/dev/null", O_WRONLY);
+    if (psBuiltin != NULL)
+    {
+      for (iArgc = 0; argv[iArgc] != NULL; iArgc++)
+        ;
+      iStatus = (*psBuiltin->pfRun)(iArgc, argv);
+      fflush(stdout);
+      _exit(iStatus);
+    }
+    snprintf(acPath, sizeof(acPath), "/usr/bin/%s", argv[0]);
+    execv(acPath, argv);
+    _exit(127);
+  }
+
+  close(aiPipe[1]);
+  *puLength = 0;
+  while ((*puLength < MAX_OUTPUT) &&
+         ((n = read(aiPipe[0], pcOutput + *puLength,
+                    MAX_OUTPUT - *puLength)) > 0))
+    *puLength += (size_t)n;
+  close(aiPipe[0]);
+  if (waitpid(pid, &iStatus, 0) != pid || ! WIFEXITED(iStatus))
+    return -1;
+  return WEXITSTATUS(iStatus);
+}
+
+static void compare(int iLineNum, char *argv[])
+
+  /* Run argv as a builtin and as the system's utility.  Report the case
+     at line iLineNum as failed if their output or exit status
+     differ. */
+
+{
+  static char acBuiltin[MAX_OUTPUT];
+  static char acSystem[MAX_OUTPUT];
+  const struct Builtin *psBuiltin;
+  size_t uBuiltin, uSystem;
+  int iBuiltin, iSystem;
+
+  iCases++;
+  psBuiltin = Builtin_lookup(argv[0], strlen(argv[0]));
+  if (psBuiltin == NULL)
+  {
+    printf("testbuiltin: line %d: %s is not a builtin.\n", iLineNum,
+           argv[0]);
+    iFailures++;
+    return;
+  }
+
+  iBuiltin = run(psBuiltin, argv, acBuiltin, &uBuiltin);
+  iSystem = run(NULL, argv, acSystem, &uSystem);
+  if ((iBuiltin != iSystem) || (uBuiltin != uSystem) ||
+      (memcmp(acBuiltin, acSystem, uSystem) != 0))
+  {
+    printf("testbuiltin: test at line %d failed.\n", iLineNum);
+    printf("  builtin: status %d, \"%.*s\"\n", iBuiltin, (int)uBuiltin,
+           acBuiltin);
+    printf("  system:  status %d, \"%.*s\"\n", iSystem, (int)uSystem,
+           acSystem);
+    fflush(stdout);
+    iFailures++;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testEcho(void)
+{
+  CASE("echo");
+  CASE("echo", "a", "b", "", "c");
+  CASE("echo", "-n", "a", "b");
+  CASE("echo", "-n");
+  CASE("echo", "-e", "a\\tb\\nc\\\\d");
+  CASE("echo", "-E", "a\\tb");
+  CASE("echo", "a\\tb");
+  CASE("echo", "-neE", "a\\tb");
+  CASE("echo", "-nE", "-e", "a\\tb");
+  CASE("echo", "-", "a");
+  CASE("echo", "-x", "a");
+  CASE("echo", "-n-e", "a");
+  CASE("echo", "--", "a");
+  CASE("echo", "-e", "\\0101\\060x\\0");
+  CASE("echo", "-e", "\\101\\7\\18");
+  CASE("echo", "-e", "\\08\\0777\\1234\\9");
+  CASE("echo", "-e", "\\x41\\x4a\\x4G\\xg");
+  CASE("echo", "-e", "a\\cb", "c");
+  CASE("echo", "-e", "\\q\\");
+  CASE("echo", "-e", "\\a\\b\\e\\f\\r\\v");
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testPrintf(void)
+{
+  CASE("printf", "hello\\n");
+  CASE("printf", "%s|%s\\n", "a");
+  CASE("printf", "%s,", "a", "b", "c");
+  CASE("printf", "[%5s][%-5s][%.2s]\\n", "ab", "cd", "efgh");
+  CASE("printf", "%d %i %o %u %x %X\\n", "42", "-7", "8", "9", "255",
+       "255");
+  CASE("printf", "%d\\n", "0x1F");
+  CASE("printf", "%d\\n", "010");
+  CASE("printf", "%d\\n", "'A");
+  CASE("printf", "%d\\n", "\"z");
+  CASE("printf", "%d\\n", "12abc");
+  CASE("printf", "%d\\n", "");
+  CASE("printf", "%d\\n", "99999999999999999999");
+  CASE("printf", "%u\\n", "-1");
+  CASE("printf", "%*d|%-*d|\\n", "5", "42", "4", "7");
+  CASE("printf", "%*.*d|\\n", "8", "4", "42");
+  CASE("printf", "%.*s|\\n", "2", "abcdef");
+  CASE("printf", "%*d|\\n", "-6", "1");
+  CASE("printf", "%+d % d %05d %#o %#x\\n", "5", "5", "5", "8", "255");
+  CASE("printf", "%f %.2f %e %g\\n", "1.5", "2.345", "1000", "0.0001");
+  CASE("printf", "%f\\n", "abc");
+  CASE("printf", "%c%c%c\\n", "abc", "", "d");
+  CASE("printf", "[%3c][%c]", "");
+  CASE("printf", "%f|%u|%x\\n", "", "", "");
+  CASE("printf", "%d|\\n", " ");
+  CASE("printf", "%%|%s\\n", "x");
+  CASE("printf", "100%");
+  CASE("printf", "abc%");
+  CASE("printf", "%5");
+  CASE("printf", "%z\\n");
+  CASE("printf", "%b\\n", "a\\tb\\\\n");
+  CASE("printf", "%b|\\n", "\\0101\\101\\060");
+  CASE("printf", "%b|\\n", "\\08\\0777\\1234\\9");
+  CASE("printf", "%b|\\n", "\\x41\\q");
+  CASE("printf", "[%b]", "a\\cb", "c");
+  CASE("printf", "[%5b]", "a");
+  CASE("printf", "%b|%b|\\n", "a\\0b");
+  CASE("printf", "%s\\c%s", "a", "b");
+  CASE("printf", "\\101\\060\\0101|\\n");
+  CASE("printf", "\\x41\\x4a|\\n");
+  CASE("printf", "%s %s\\n", "a", "b", "c");
+  CASE("printf", "no conversions\\n", "extra");
+  CASE("printf");
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testTest(void)
+{
+  CASE("test");
+  CASE("test", "");
+  CASE("test", "a");
+  CASE("test", "-n");
+  CASE("test", "!");
+  CASE("test", "-n", "");
+  CASE("test", "-z", "");
+  CASE("test", "-n", "a");
+  CASE("test", "!", "a");
+  CASE("test", "!", "");
+  CASE("test", "a", "=", "a");
+  CASE("test", "a", "=", "b");
+  CASE("test", "a", "!=", "b");
+  CASE("test", "a", "<", "b");
+  CASE("test", "b", ">", "a");
+  CASE("test", "!", "a", "=", "b");
+  CASE("test", "!", "(", "a", "=", "b", ")");
+  CASE("test", "!", "(", "a", "=", "a", ")");
+  CASE("test", "(", "a", "=", "b", ")");
+  CASE("test", "(", "", ")");
+  CASE("test", "(", "!", "a", ")");
+  CASE("test", "!", "!", "a");
+  CASE("test", "=", "=", "=");
+  CASE("test", "-a", "=", "-a");
+  CASE("test", "(", "=", ")");
+  CASE("test", "a", "-a", "");
+  CASE("test", "a", "-o", "");
+  CASE("test", "", "-o", "", "-a", "a");
+  CASE("test", "a", "-o", "", "-a", "");
+  CASE("test", "", "-a", "a", "-o", "a");
+  CASE("test", "a", "-o", "a", "-a", "");
+  CASE("test", "!", "a", "-o", "a");
+  CASE("test", "!", "", "-a", "a");
+  CASE("test", "(", "a", "-o", "", ")", "-a", "");
+  CASE("test", "a", "-a", "(", "", "-o", "b", ")");
+  CASE("test", "1", "-eq", "1");
+  CASE("test", "1", "-lt", "2", "-a", "3", "-ge", "4");
+  CASE("test", " 7 ", "-eq", "7");
+  CASE("test", "-3", "-le", "-3");
+  CASE("test", "1", "-eq", "x");
+  CASE("test", "1", "-eq");
+  CASE("test", "(", "a");
+  CASE("test", "a", "b");
+  CASE("test", "a", "=", "a", "b");
+  CASE("test", "-x", "a");
+  CASE("test", "-d", "/");
+  CASE("test", "-f", "/");
+  CASE("test", "-e", "/nonexistent");
+  CASE("test", "-r", "/dev/null", "-a", "-c", "/dev/null");
+  CASE("test", "/", "-ef", "/");
+  CASE("test", "-t", "99");
+  CASE("test", "-t", "x");
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Run the tests.  Return 0 iff all of them pass. */
+
+{
+  errorPrint("testbuiltin", SETUP);
+
+  testEcho();
+  testPrintf();
+  testTest();
+
+  if (iFailures > 0)
+  {
+    printf("testbuiltin: %d of %d test(s) failed.\n", iFailures, iCases);
+    return 1;
+  }
+  printf("testbuiltin: all %d tests passed.\n", iCases);
+  return 0;
+}
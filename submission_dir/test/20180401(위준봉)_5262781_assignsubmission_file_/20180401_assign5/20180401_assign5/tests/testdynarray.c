@@ -0,0 +1,393 @@
+/*--------------------------------------------------------------------*/
+/* testdynarray.c                                                     */
+/* A test client for the DynArray ADT.                                */
+/*--------------------------------------------------------------------*/
+
+#include "../dynarray.c"
+#include <stdio.h>
+
+/*--------------------------------------------------------------------*/
+
+static int iFailures = 0;
+
+#define ASSURE(iSuccessful) assure(iSuccessful, __LINE__)
+
+static void assure(int iSuccessful, int iLineNum)
+
+  /* If !iSuccessful, report the test at line iLineNum as failed. */
+
+{
+  if (! iSuccessful)
+  {
+    printf("testdynarray: test at line %d failed.\n", iLineNum);
+    fflush(stdout);
+    iFailures++;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The elements are the addresses of aiValues[i], so a test can tell
+   which element is where by its value. */
+enum {MAX_VALUES = 1000};
+static int aiValues[MAX_VALUES];
+
+static DynArray_T makeArray(int iLength)
+
+  /* Return a new DynArray_T holding &aiValues[0...iLength-1]. */
+
+{
+  DynArray_T oDynArray = DynArray_new(0);
+  int i;
+
+  for (i = 0; i < iLength; i++)
+  {
+    aiValues[i] = i;
+    DynArray_add(oDynArray, &aiValues[i]);
+  }
+  return oDynArray;
+}
+
+static int valueAt(DynArray_T oDynArray, int iIndex)
+
+  /* Return the value of the iIndex'th element of oDynArray. */
+
+{
+  return *(int*)DynArray_get(oDynArray, iIndex);
+}
+
+/*--------------------------------------------------------------------*/
+
+static int physLengthAfter(enum DynArrayGrowth eGrowth, int iStep,
+    int iLength)
+
+  /* Return the physical length of a DynArray_T growing as eGrowth and
+     iStep say, after adding iLength elements one at a time. */
+
+{
+  DynArray_T oDynArray = DynArray_new(0);
+  int iPhysLength;
+  int i;
+
+  DynArray_setGrowth(oDynArray, eGrowth, iStep);
+  for (i = 0; i < iLength; i++)
+    DynArray_add(oDynArray, &aiValues[i % MAX_VALUES]);
+  iPhysLength = oDynArray->iPhysLength;
+  DynArray_free(oDynArray);
+  return iPhysLength;
+}
+
+static void testGrowth(void)
+
+  /* Test DynArray_setGrowth(), DynArray_reserve(),
+     DynArray_shrinkToFit(), DynArray_addArray() and
+     DynArray_addAll(). */
+
+{
+  DynArray_T oDynArray;
+  DynArray_T oOther;
+  Arena_T oArena;
+  void *apvElements[40];
+  int i;
+
+  /* The three policies, from the inline array up. */
+  ASSURE(physLengthAfter(DYNARRAY_GROW_DOUBLE, 0, 16) == 16);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_DOUBLE, 0, 17) == 32);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_DOUBLE, 0, 65) == 128);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_HALF, 0, 17) == 24);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_HALF, 0, 25) == 36);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_HALF, 0, 37) == 54);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_STEP, 10, 17) == 26);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_STEP, 10, 27) == 36);
+  ASSURE(physLengthAfter(DYNARRAY_GROW_STEP, 1, 100) == 100);
+
+  /* reserve grows to exactly the capacity and never shrinks; the
+     elements survive the move out of the inline array. */
+  oDynArray = makeArray(10);
+  ASSURE(DynArray_reserve(oDynArray, 8));
+  ASSURE(oDynArray->iPhysLength == DYNARRAY_INLINE_LENGTH);
+  ASSURE(DynArray_reserve(oDynArray, 100));
+  ASSURE(oDynArray->iPhysLength == 100);
+  ASSURE(oDynArray->ppvArray != oDynArray->apvInline);
+  for (i = 0; i < 10; i++)
+    ASSURE(valueAt(oDynArray, i) == i);
+  ASSURE(DynArray_reserve(oDynArray, 50));
+  ASSURE(oDynArray->iPhysLength == 100);
+
+  /* shrinkToFit goes back to the inline array when the elements fit,
+     and to exactly the length when they do not. */
+  DynArray_shrinkToFit(oDynArray);
+  ASSURE(oDynArray->ppvArray == oDynArray->apvInline);
+  ASSURE(DynArray_getLength(oDynArray) == 10);
+  for (i = 0; i < 10; i++)
+    ASSURE(valueAt(oDynArray, i) == i);
+  DynArray_free(oDynArray);
+  oDynArray = makeArray(100);
+  DynArray_shrinkToFit(oDynArray);
+  ASSURE(oDynArray->iPhysLength == 100);
+  for (i = 0; i < 100; i++)
+    ASSURE(valueAt(oDynArray, i) == i);
+
+  /* ... keeping the NULL slot. */
+  ASSURE(DynArray_setNullTerminated(oDynArray));
+  while (DynArray_getLength(oDynArray) > 20)
+    DynArray_removeAt(oDynArray, DynArray_getLength(oDynArray) - 1);
+  DynArray_shrinkToFit(oDynArray);
+  ASSURE(oDynArray->iPhysLength == 21);
+  ASSURE(DynArray_asArgv(oDynArray)[20] == NULL);
+  DynArray_free(oDynArray);
+
+  /* addArray: nothing, into the inline array, then past it in one
+     step. */
+  for (i = 0; i < 40; i++)
+    apvElements[i] = &aiValues[i];
+  oDynArray = DynArray_new(0);
+  ASSURE(DynArray_addArray(oDynArray, NULL, 0));
+  ASSURE(DynArray_getLength(oDynArray) == 0);
+  ASSURE(DynArray_addArray(oDynArray, apvElements, 10));
+  ASSURE(oDynArray->ppvArray == oDynArray->apvInline);
+  ASSURE(DynArray_addArray(oDynArray, apvElements + 10, 30));
+  ASSURE(DynArray_getLength(oDynArray) == 40);
+  ASSURE(oDynArray->iPhysLength == 64);
+  for (i = 0; i < 40; i++)
+    ASSURE(valueAt(oDynArray, i) == i);
+
+  /* addAll from another array and from itself, which has to grow
+     first and so moves its own source. */
+  oOther = makeArray(5);
+  ASSURE(DynArray_addAll(oOther, oDynArray));
+  ASSURE(DynArray_getLength(oOther) == 45);
+  for (i = 0; i < 45; i++)
+    ASSURE(valueAt(oOther, i) == ((i < 5) ? i : i - 5));
+  ASSURE(DynArray_addAll(oDynArray, oDynArray));
+  ASSURE(DynArray_getLength(oDynArray) == 80);
+  for (i = 0; i < 80; i++)
+    ASSURE(valueAt(oDynArray, i) == i % 40);
+  DynArray_free(oOther);
+  DynArray_free(oDynArray);
+
+  /* The same from an arena, with a growth policy. */
+  oArena = Arena_new();
+  ASSURE(oArena != NULL);
+  oDynArray = DynArray_newIn(oArena, 0);
+  ASSURE(oDynArray != NULL);
+  DynArray_setGrowth(oDynArray, DYNARRAY_GROW_STEP, 7);
+  ASSURE(DynArray_addArray(oDynArray, apvElements, 40));
+  ASSURE(oDynArray->iPhysLength == 44);
+  ASSURE(DynArray_addAll(oDynArray, oDynArray));
+  ASSURE(DynArray_getLength(oDynArray) == 80);
+  for (i = 0; i < 80; i++)
+    ASSURE(valueAt(oDynArray, i) == i % 40);
+  while (DynArray_getLength(oDynArray) > 4)
+    DynArray_removeAt(oDynArray, DynArray_getLength(oDynArray) - 1);
+  DynArray_shrinkToFit(oDynArray);
+  ASSURE(oDynArray->ppvArray == oDynArray->apvInline);
+  for (i = 0; i < 4; i++)
+    ASSURE(valueAt(oDynArray, i) == i);
+  Arena_free(oArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Elements for the sort tests: pointers to these, compared by
+   value. */
+enum {SORT_LENGTH = 100000};
+static int aiSort[SORT_LENGTH];
+static long lCompares;
+
+static int compareInts(const void *pvOne, const void *pvTwo)
+{
+  int iOne = *(const int*)pvOne;
+  int iTwo = *(const int*)pvTwo;
+
+  lCompares++;
+  return (iOne > iTwo) - (iOne < iTwo);
+}
+
+static unsigned long ulSeed = 1;
+
+static int nextRandom(void)
+
+  /* Return the next number of a fixed pseudo-random sequence. */
+
+{
+  ulSeed = ulSeed * 1103515245UL + 12345UL;
+  return (int)((ulSeed >> 16) & 0x7fffffff);
+}
+
+static DynArray_T makeSortArray(int iLength, int iPattern)
+
+  /* Return a new DynArray_T of iLength elements pointing into aiSort,
+     whose values are ascending (0), descending (1), random (2), all
+     equal (3) or drawn from only four values (4). */
+
+{
+  DynArray_T oDynArray = DynArray_newWithCapacity(iLength);
+  int i;
+
+  for (i = 0; i < iLength; i++)
+  {
+    switch (iPattern)
+    {
+      case 0: aiSort[i] = i; break;
+      case 1: aiSort[i] = iLength - i; break;
+      case 2: aiSort[i] = nextRandom(); break;
+      case 3: aiSort[i] = 7; break;
+      default: aiSort[i] = nextRandom() % 4; break;
+    }
+    DynArray_add(oDynArray, &aiSort[i]);
+  }
+  return oDynArray;
+}
+
+static int isSorted(DynArray_T oDynArray)
+
+  /* Return 1 (TRUE) iff oDynArray is in ascending order and still
+     holds each element of aiSort once. */
+
+{
+  static char acSeen[SORT_LENGTH];
+  int *piElement;
+  int i;
+
+  memset(acSeen, 0, sizeof(acSeen));
+  for (i = 0; i < DynArray_getLength(oDynArray); i++)
+  {
+    piElement = DynArray_get(oDynArray, i);
+    if ((i > 0) && (*(int*)DynArray_get(oDynArray, i - 1) > *piElement))
+      return 0;
+    if (acSeen[piElement - aiSort]++)
+      return 0;
+  }
+  return 1;
+}
+
+/* McIlroy's adversary ("A Killer Adversary for Quicksort", 1999): it
+   decides the values of the elements only as the sort compares them,
+   so that every pivot turns out to be close to the smallest element.
+   It makes a plain quicksort take quadratic time, so introsort has to
+   fall back to heapsort to stay O(n log n). */
+
+static int aiAdversary[SORT_LENGTH];
+static int iSolid;
+static int iCandidate;
+static int iGas;
+
+static int compareAdversary(const void *pvOne, const void *pvTwo)
+{
+  int iOne = *(const int*)pvOne;
+  int iTwo = *(const int*)pvTwo;
+
+  lCompares++;
+  if ((aiAdversary[iOne] == iGas) && (aiAdversary[iTwo] == iGas))
+  {
+    if (iOne == iCandidate)
+      aiAdversary[iOne] = iSolid++;
+    else
+      aiAdversary[iTwo] = iSolid++;
+  }
+  if (aiAdversary[iOne] == iGas)
+    iCandidate = iOne;
+  else if (aiAdversary[iTwo] == iGas)
+    iCandidate = iTwo;
+  return aiAdversary[iOne] - aiAdversary[iTwo];
+}
+
+static int log2Floor(int n)
+{
+  int iLog = 0;
+
+  while (n > 1)
+  {
+    n /= 2;
+    iLog++;
+  }
+  return iLog;
+}
+
+static void testSort(void)
+
+  /* Test DynArray_sort() and the heapsort fallback of introsort. */
+
+{
+  static const int aiLengths[] = {0, 1, 2, 3, 16, 17, 100, 1000, 20000};
+  DynArray_T oDynArray;
+  size_t u;
+  int iPattern;
+  int iLength;
+  int i;
+
+  /* Every pattern at lengths around the insertion sort cutoff and
+     above it; comparisons stay O(n log n) even for the inputs that
+     made the old last-element pivot quadratic. */
+  for (u = 0; u < sizeof(aiLengths) / sizeof(aiLengths[0]); u++)
+    for (iPattern = 0; iPattern <= 4; iPattern++)
+    {
+      iLength = aiLengths[u];
+      oDynArray = makeSortArray(iLength, iPattern);
+      lCompares = 0;
+      DynArray_sort(oDynArray, compareInts);
+      ASSURE(isSorted(oDynArray));
+      if (iLength > 16)
+        ASSURE(lCompares <= 4L * iLength * log2Floor(iLength));
+      DynArray_free(oDynArray);
+    }
+
+  /* The heapsort fallback directly, and introsort with no partitions
+     left to spend, which must go straight to it. */
+  oDynArray = makeSortArray(1000, 2);
+  DynArray_heapsort(oDynArray->ppvArray, 0, 999, compareInts);
+  ASSURE(isSorted(oDynArray));
+  DynArray_free(oDynArray);
+  for (iPattern = 0; iPattern <= 4; iPattern++)
+  {
+    oDynArray = makeSortArray(1000, iPattern);
+    DynArray_introsort(oDynArray->ppvArray, 0, 999, 0, compareInts);
+    ASSURE(isSorted(oDynArray));
+    DynArray_free(oDynArray);
+    oDynArray = makeSortArray(1000, iPattern);
+    DynArray_introsort(oDynArray->ppvArray, 0, 999, 1, compareInts);
+    ASSURE(isSorted(oDynArray));
+    DynArray_free(oDynArray);
+  }
+
+  /* The adversary: the depth limit has to kick in. */
+  iLength = SORT_LENGTH;
+  oDynArray = DynArray_newWithCapacity(iLength);
+  iGas = iLength;
+  iSolid = 0;
+  iCandidate = 0;
+  for (i = 0; i < iLength; i++)
+  {
+    aiSort[i] = i;
+    aiAdversary[i] = iGas;
+    DynArray_add(oDynArray, &aiSort[i]);
+  }
+  lCompares = 0;
+  DynArray_sort(oDynArray, compareAdversary);
+  ASSURE(lCompares <= 8L * iLength * log2Floor(iLength));
+  for (i = 1; i < iLength; i++)
+    ASSURE(aiAdversary[*(int*)DynArray_get(oDynArray, i - 1)] <=
+           aiAdversary[*(int*)DynArray_get(oDynArray, i)]);
+  DynArray_free(oDynArray);
+
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Run the tests.  Return 0 iff all of them pass. */
+
+{
+  testGrowth();
+  testSort();
+
+  if (iFailures > 0)
+  {
+    printf("testdynarray: %d test(s) failed.\n", iFailures);
+    return 1;
+  }
+  printf("testdynarray: all tests passed.\n");
+  return 0;
+}
@@ -0,0 +1,244 @@
+/*--------------------------------------------------------------------*/
+/* testdyndeque.c                                                     */
+/* A test client for the DynDeque ADT.                                */
+/*--------------------------------------------------------------------*/
+
+#include "../dyndeque.c"
+#include <stdio.h>
+
+/*--------------------------------------------------------------------*/
+
+static int iFailures = 0;
+
+#define ASSURE(iSuccessful) assure(iSuccessful, __LINE__)
+
+static void assure(int iSuccessful, int iLineNum)
+
+  /* If !iSuccessful, report the test at line iLineNum as failed. */
+
+{
+  if (! iSuccessful)
+  {
+    printf("testdyndeque: test at line %d failed.\n", iLineNum);
+    fflush(stdout);
+    iFailures++;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The elements are the addresses of aiValues[i]. */
+enum {MAX_VALUES = 4096};
+static int aiValues[MAX_VALUES];
+
+static int valueAt(DynDeque_T oDynDeque, int iIndex)
+
+  /* Return the value of the iIndex'th element of oDynDeque. */
+
+{
+  return *(int*)DynDeque_get(oDynDeque, iIndex);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testWraparound(void)
+
+  /* Test pushes and pops across the end of the array, and growing
+     while the elements wrap around. */
+
+{
+  DynDeque_T oDynDeque;
+  int i;
+
+  /* pushFront on an empty deque wraps to the last slot. */
+  oDynDeque = DynDeque_new();
+  ASSURE(oDynDeque != NULL);
+  ASSURE(DynDeque_pushFront(oDynDeque, &aiValues[0]));
+  ASSURE(oDynDeque->iFront == MIN_PHYS_LENGTH - 1);
+  ASSURE(DynDeque_popBack(oDynDeque) == &aiValues[0]);
+  ASSURE(DynDeque_getLength(oDynDeque) == 0);
+
+  /* Fill the array with the front in the middle: 3 in front, 5 at
+     the back. */
+  for (i = 3; i < 8; i++)
+    ASSURE(DynDeque_pushBack(oDynDeque, &aiValues[i]));
+  for (i = 2; i >= 0; i--)
+    ASSURE(DynDeque_pushFront(oDynDeque, &aiValues[i]));
+  ASSURE(oDynDeque->iPhysLength == MIN_PHYS_LENGTH);
+  ASSURE(oDynDeque->iFront != 0);
+  for (i = 0; i < 8; i++)
+    ASSURE(valueAt(oDynDeque, i) == i);
+
+  /* The next push grows it, unwrapping the elements. */
+  ASSURE(DynDeque_pushBack(oDynDeque, &aiValues[8]));
+  ASSURE(oDynDeque->iPhysLength == 2 * MIN_PHYS_LENGTH);
+  ASSURE(oDynDeque->iFront == 0);
+  ASSURE(DynDeque_getLength(oDynDeque) == 9);
+  for (i = 0; i < 9; i++)
+    ASSURE(valueAt(oDynDeque, i) == i);
+
+  /* Again from the front end, while wrapped. */
+  DynDeque_free(oDynDeque);
+  oDynDeque = DynDeque_new();
+  for (i = 0; i < 8; i++)
+    ASSURE(DynDeque_pushFront(oDynDeque, &aiValues[7 - i]));
+  ASSURE(DynDeque_pushFront(oDynDeque, &aiValues[MAX_VALUES - 1]));
+  ASSURE(oDynDeque->iPhysLength == 2 * MIN_PHYS_LENGTH);
+  ASSURE(valueAt(oDynDeque, 0) == MAX_VALUES - 1);
+  for (i = 0; i < 8; i++)
+    ASSURE(valueAt(oDynDeque, i + 1) == i);
+
+  /* A queue going round the array many times never grows. */
+  DynDeque_free(oDynDeque);
+  oDynDeque = DynDeque_new();
+  for (i = 0; i < 5; i++)
+    ASSURE(DynDeque_pushBack(oDynDeque, &aiValues[i]));
+  for (i = 5; i < 1000; i++)
+  {
+    ASSURE(DynDeque_pushBack(oDynDeque, &aiValues[i]));
+    ASSURE(DynDeque_popFront(oDynDeque) == &aiValues[i - 5]);
+  }
+  ASSURE(oDynDeque->iPhysLength == MIN_PHYS_LENGTH);
+  for (i = 0; i < 5; i++)
+    ASSURE(valueAt(oDynDeque, i) == 995 + i);
+  DynDeque_free(oDynDeque);
+
+  /* DynDeque_free(NULL) does nothing. */
+  DynDeque_free(NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testFromDynArray(void)
+
+  /* Test DynDeque_fromDynArray() at lengths around the powers of two,
+     and pushing to both ends of the result. */
+
+{
+  static const int aiLengths[] = {0, 1, 7, 8, 9, 16, 17, 100};
+  DynArray_T oDynArray;
+  DynDeque_T oDynDeque;
+  size_t u;
+  int iLength;
+  int i;
+
+  for (u = 0; u < sizeof(aiLengths) / sizeof(aiLengths[0]); u++)
+  {
+    iLength = aiLengths[u];
+    oDynArray = DynArray_new(0);
+    for (i = 0; i < iLength; i++)
+      DynArray_add(oDynArray, &aiValues[i + 1]);
+    oDynDeque = DynDeque_fromDynArray(oDynArray);
+    DynArray_free(oDynArray);
+
+    ASSURE(oDynDeque != NULL);
+    ASSURE(DynDeque_getLength(oDynDeque) == iLength);
+    ASSURE(oDynDeque->iPhysLength >= iLength);
+    for (i = 0; i < iLength; i++)
+      ASSURE(valueAt(oDynDeque, i) == i + 1);
+
+    ASSURE(DynDeque_pushFront(oDynDeque, &aiValues[0]));
+    ASSURE(DynDeque_pushBack(oDynDeque, &aiValues[iLength + 1]));
+    ASSURE(DynDeque_getLength(oDynDeque) == iLength + 2);
+    for (i = 0; i < iLength + 2; i++)
+      ASSURE(valueAt(oDynDeque, i) == i);
+    DynDeque_free(oDynDeque);
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static unsigned long ulSeed = 1;
+
+static int nextRandom(void)
+
+  /* Return the next number of a fixed pseudo-random sequence. */
+
+{
+  ulSeed = ulSeed * 1103515245UL + 12345UL;
+  return (int)((ulSeed >> 16) & 0x7fffffff);
+}
+
+static void testRandom(void)
+
+  /* Run random pushes and pops at both ends against a plain array
+     that holds the same sequence from index iModelFront on. */
+
+{
+  enum {MODEL_LENGTH = 3 * MAX_VALUES};
+  static int *apiModel[MODEL_LENGTH];
+  int iModelFront = MAX_VALUES;
+  int iModelLength = 0;
+  DynDeque_T oDynDeque;
+  int iStep;
+  int i;
+
+  oDynDeque = DynDeque_new();
+  for (iStep = 0; iStep < 20000; iStep++)
+  {
+    /* Pushes win slightly, so the deque grows through several
+       sizes while it wraps around. */
+    switch (nextRandom() % 9)
+    {
+      case 0: case 1:
+        if (iModelFront == 0)
+          break;
+        i = nextRandom() % MAX_VALUES;
+        ASSURE(DynDeque_pushFront(oDynDeque, &aiValues[i]));
+        apiModel[--iModelFront] = &aiValues[i];
+        iModelLength++;
+        break;
+      case 2: case 3: case 4:
+        if (iModelFront + iModelLength == MODEL_LENGTH)
+          break;
+        i = nextRandom() % MAX_VALUES;
+        ASSURE(DynDeque_pushBack(oDynDeque, &aiValues[i]));
+        apiModel[iModelFront + iModelLength++] = &aiValues[i];
+        break;
+      case 5: case 6:
+        if (iModelLength == 0)
+          break;
+        ASSURE(DynDeque_popFront(oDynDeque) == apiModel[iModelFront]);
+        iModelFront++;
+        iModelLength--;
+        break;
+      default:
+        if (iModelLength == 0)
+          break;
+        ASSURE(DynDeque_popBack(oDynDeque) ==
+               apiModel[iModelFront + --iModelLength]);
+        break;
+    }
+    ASSURE(DynDeque_isValid(oDynDeque));
+    ASSURE(DynDeque_getLength(oDynDeque) == iModelLength);
+  }
+  for (i = 0; i < iModelLength; i++)
+    ASSURE(DynDeque_get(oDynDeque, i) == apiModel[iModelFront + i]);
+  ASSURE(oDynDeque->iPhysLength > MIN_PHYS_LENGTH);
+  DynDeque_free(oDynDeque);
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Run the tests.  Return 0 iff all of them pass. */
+
+{
+  int i;
+
+  for (i = 0; i < MAX_VALUES; i++)
+    aiValues[i] = i;
+
+  testWraparound();
+  testFromDynArray();
+  testRandom();
+
+  if (iFailures > 0)
+  {
+    printf("testdyndeque: %d test(s) failed.\n", iFailures);
+    return 1;
+  }
+  printf("testdyndeque: all tests passed.\n");
+  return 0;
+}
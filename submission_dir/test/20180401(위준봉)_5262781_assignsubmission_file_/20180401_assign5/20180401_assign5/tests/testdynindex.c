@@ -0,0 +1,282 @@
+/*--------------------------------------------------------------------*/
+/* testdynindex.c                                                     */
+/* A test client for the DynIndex ADT.                                */
+/*--------------------------------------------------------------------*/
+
+#include "../dynindex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+static int iFailures = 0;
+
+#define ASSURE(iSuccessful) assure(iSuccessful, __LINE__)
+
+static void assure(int iSuccessful, int iLineNum)
+
+  /* If !iSuccessful, report the test at line iLineNum as failed. */
+
+{
+  if (! iSuccessful)
+  {
+    printf("testdynindex: test at line %d failed.\n", iLineNum);
+    fflush(stdout);
+    iFailures++;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+enum {MAX_KEYS = 200};
+enum {MAX_KEY_LENGTH = 16};
+
+/* Key i is "k" followed by 2*i+1 in five digits, so that "k" followed
+   by an even number falls between two keys. */
+static char aacKeys[MAX_KEYS][MAX_KEY_LENGTH];
+
+static DynArray_T makeKeys(int iLength)
+
+  /* Return a new DynArray_T of the first iLength keys, in order. */
+
+{
+  DynArray_T oDynArray = DynArray_new(0);
+  int i;
+
+  for (i = 0; i < iLength; i++)
+  {
+    sprintf(aacKeys[i], "k%05d", 2 * i + 1);
+    DynArray_add(oDynArray, aacKeys[i]);
+  }
+  return oDynArray;
+}
+
+static int compareKeys(const void *pvOne, const void *pvTwo)
+{
+  return strcmp((const char*)pvOne, (const char*)pvTwo);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testShapes(void)
+
+  /* Search every key, and every gap before, between and after them,
+     in indexes of every length up to MAX_KEYS, so that each shape of
+     the last tree level is covered; compare with DynArray_bsearch(). */
+
+{
+  DynArray_T oDynArray;
+  DynIndex_T oDynIndex;
+  char acGap[MAX_KEY_LENGTH];
+  int iLength;
+  int i;
+
+  for (iLength = 0; iLength <= MAX_KEYS; iLength++)
+  {
+    oDynArray = makeKeys(iLength);
+    oDynIndex = DynIndex_new(oDynArray, NULL);
+    ASSURE(oDynIndex != NULL);
+
+    for (i = 0; i < iLength; i++)
+      ASSURE(DynIndex_search(oDynIndex, aacKeys[i]) == i);
+    for (i = 0; i <= iLength; i++)
+    {
+      sprintf(acGap, "k%05d", 2 * i);
+      ASSURE(DynIndex_search(oDynIndex, acGap) == -1);
+      ASSURE(DynArray_bsearch(oDynArray, acGap, compareKeys) == -1);
+    }
+
+    /* Before the first key and after the last, also as prefixes of
+       them and with them as prefixes. */
+    ASSURE(DynIndex_search(oDynIndex, "") == -1);
+    ASSURE(DynIndex_search(oDynIndex, "a") == -1);
+    ASSURE(DynIndex_search(oDynIndex, "k") == -1);
+    ASSURE(DynIndex_search(oDynIndex, "k0000") == -1);
+    ASSURE(DynIndex_search(oDynIndex, "k000010") == -1);
+    ASSURE(DynIndex_search(oDynIndex, "z") == -1);
+    ASSURE(DynIndex_search(oDynIndex, "\xff") == -1);
+
+    DynIndex_free(oDynIndex);
+    DynArray_free(oDynArray);
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Keys that only differ at or past their eighth byte, where the
+   inline prefix stops, and keys with bytes above 0x7f, which strcmp()
+   orders as unsigned. */
+static const char *const apcLongKeys[] = {
+  "",
+  "abcdefg",
+  "abcdefgh",
+  "abcdefgh\x01",
+  "abcdefgha",
+  "abcdefghab",
+  "abcdefghb",
+  "abcdefgi",
+  "abcdefgz",
+  "abcdefgz\xff",
+  "\x7f",
+  "\x80",
+  "\xff\xff\xff\xff\xff\xff\xff\xff",
+  "\xff\xff\xff\xff\xff\xff\xff\xff\xff"
+};
+
+struct Entry
+{
+  const char *pcName;
+  int iValue;
+};
+
+static const char *getName(const void *pvElement)
+{
+  return ((const struct Entry*)pvElement)->pcName;
+}
+
+static void testPrefixes(void)
+
+  /* Search keys that share their inline prefix, through pfGetKey. */
+
+{
+  enum {LONG_KEYS = sizeof(apcLongKeys) / sizeof(apcLongKeys[0])};
+  struct Entry asEntries[LONG_KEYS];
+  DynArray_T oDynArray;
+  DynIndex_T oDynIndex;
+  int i;
+
+  oDynArray = DynArray_new(0);
+  for (i = 0; i < LONG_KEYS; i++)
+  {
+    if (i > 0)
+      ASSURE(strcmp(apcLongKeys[i - 1], apcLongKeys[i]) < 0);
+    asEntries[i].pcName = apcLongKeys[i];
+    asEntries[i].iValue = i;
+    DynArray_add(oDynArray, &asEntries[i]);
+  }
+  oDynIndex = DynIndex_new(oDynArray, getName);
+  ASSURE(oDynIndex != NULL);
+
+  for (i = 0; i < LONG_KEYS; i++)
+    ASSURE(DynIndex_search(oDynIndex, apcLongKeys[i]) == i);
+  ASSURE(DynIndex_search(oDynIndex, "abcdef") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "abcdefgh\x02") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "abcdefghaa") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "abcdefghabc") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "abcdefgz\xfe") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "\xff\xff\xff\xff\xff\xff\xff") == -1);
+  ASSURE(DynIndex_search(oDynIndex,
+      "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff") == -1);
+
+  DynIndex_free(oDynIndex);
+  DynArray_free(oDynArray);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testCommonPrefix(void)
+
+  /* Search tables whose keys all start with the same bytes, which the
+     index compares once per search: keys that share them only in part,
+     or are shorter, are not found. */
+
+{
+  static const char *const apcPaths[] = {
+    "/usr/bin/", "/usr/bin/cat", "/usr/bin/catman", "/usr/bin/tee",
+    "/usr/bin/teeny", "/usr/bin/z"};
+  enum {PATHS = sizeof(apcPaths) / sizeof(apcPaths[0])};
+  DynArray_T oDynArray;
+  DynIndex_T oDynIndex;
+  int i;
+
+  oDynArray = DynArray_new(0);
+  for (i = 0; i < PATHS; i++)
+    DynArray_add(oDynArray, apcPaths[i]);
+  oDynIndex = DynIndex_new(oDynArray, NULL);
+  ASSURE(oDynIndex != NULL);
+  for (i = 0; i < PATHS; i++)
+    ASSURE(DynIndex_search(oDynIndex, apcPaths[i]) == i);
+  ASSURE(DynIndex_search(oDynIndex, "") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "/usr/bin") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "/usr/bim/cat") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "/usr/bin/ca") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "/usr/bin/cats") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "/usr/bin/zz") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "/usr/sbin/cat") == -1);
+  DynIndex_free(oDynIndex);
+
+  /* One key, and several equal keys: the common prefix is the whole
+     key. */
+  DynArray_free(oDynArray);
+  oDynArray = DynArray_new(0);
+  DynArray_add(oDynArray, "only");
+  oDynIndex = DynIndex_new(oDynArray, NULL);
+  ASSURE(DynIndex_search(oDynIndex, "only") == 0);
+  ASSURE(DynIndex_search(oDynIndex, "onl") == -1);
+  ASSURE(DynIndex_search(oDynIndex, "only1") == -1);
+  DynIndex_free(oDynIndex);
+  DynArray_add(oDynArray, "only");
+  DynArray_add(oDynArray, "only");
+  oDynIndex = DynIndex_new(oDynArray, NULL);
+  i = DynIndex_search(oDynIndex, "only");
+  ASSURE((i >= 0) && (i <= 2));
+  ASSURE(DynIndex_search(oDynIndex, "only ") == -1);
+  DynIndex_free(oDynIndex);
+  DynArray_free(oDynArray);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testDuplicates(void)
+
+  /* A key that occurs several times is found at one of its indexes,
+     as DynArray_bsearch() would find it. */
+
+{
+  static const char *const apcKeys[] = {"a", "b", "b", "b", "c", "c"};
+  DynArray_T oDynArray;
+  DynIndex_T oDynIndex;
+  size_t u;
+  int i;
+
+  oDynArray = DynArray_new(0);
+  for (u = 0; u < sizeof(apcKeys) / sizeof(apcKeys[0]); u++)
+    DynArray_add(oDynArray, apcKeys[u]);
+  oDynIndex = DynIndex_new(oDynArray, NULL);
+  ASSURE(oDynIndex != NULL);
+
+  i = DynIndex_search(oDynIndex, "b");
+  ASSURE((i >= 1) && (i <= 3));
+  i = DynIndex_search(oDynIndex, "c");
+  ASSURE((i >= 4) && (i <= 5));
+  ASSURE(DynIndex_search(oDynIndex, "a") == 0);
+  ASSURE(DynIndex_search(oDynIndex, "bb") == -1);
+
+  DynIndex_free(oDynIndex);
+  DynArray_free(oDynArray);
+
+  /* DynIndex_free(NULL) does nothing. */
+  DynIndex_free(NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Run the tests.  Return 0 iff all of them pass. */
+
+{
+  testShapes();
+  testPrefixes();
+  testCommonPrefix();
+  testDuplicates();
+
+  if (iFailures > 0)
+  {
+    printf("testdynindex: %d test(s) failed.\n", iFailures);
+    return 1;
+  }
+  printf("testdynindex: all tests passed.\n");
+  return 0;
+}
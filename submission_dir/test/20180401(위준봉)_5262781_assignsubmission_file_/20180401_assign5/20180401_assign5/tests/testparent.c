@@ -0,0 +1,196 @@
+/*--------------------------------------------------------------------*/
+/* testparent.c                                                       */
+/* A test client for the builtins that run in the shell itself: runs  */
+/* lines through ../ish in an empty directory and checks what it      */
+/* prints, that it survives them, and that a misused builtin leaves   */
+/* the shell and the directory as they were.                          */
+/*--------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+/*--------------------------------------------------------------------*/
+
+static int iFailures = 0;
+
+enum {MAX_OUTPUT = 4096};
+
+/* The shell under test, and the empty directory it runs in. */
+static char acIsh[PATH_MAX];
+static char acDir[] = "/tmp/testparentXXXXXX";
+
+/*--------------------------------------------------------------------*/
+
+static size_t readAll(int iFd, char *pcBuffer)
+
+  /* Read iFd to its end into pcBuffer, keeping at most MAX_OUTPUT - 1
+     bytes, and end them with '\0'.  Return their number. */
+
+{
+  size_t uLength = 0;
+  ssize_t n;
+
+  while ((uLength < MAX_OUTPUT - 1) &&
+         ((n = read(iFd, pcBuffer + uLength,
+                    MAX_OUTPUT - 1 - uLength)) > 0))
+    uLength += (size_t)n;
+  pcBuffer[uLength] = '\0';
+  return uLength;
+}
+
+static int runIsh(const char *pcInput, char *pcOut, char *pcErr)
+
+  /* Run ish in acDir, with HOME set to it, on the lines pcInput.  Store
+     its stdout in pcOut and its stderr in pcErr.  Return its exit
+     status, or -1 if it did not exit. */
+
+{
+  int aiIn[2], aiOut[2], aiErr[2];
+  int iStatus;
+  pid_t pid;
+
+  if ((pipe(aiIn) < 0) || (pipe(aiOut) < 0) || (pipe(aiErr) < 0))
+  {
+    perror("pipe");
+    exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  pid = fork();
+  if (pid < 0)
+  {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  if (pid == 0)
+  {
+    dup2(aiIn[0], STDIN_FILENO);
+    dup2(aiOut[1], STDOUT_FILENO);
+    dup2(aiErr[1], STDERR_FILENO);
+    close(aiIn[0]);
+    close(aiIn[1]);
+    close(aiOut[0]);
+    close(aiOut[1]);
+    close(aiErr[0]);
+    close(aiErr[1]);
+    if (chdir(acDir) < 0)
+      _exit(127);
+    setenv("HOME", acDir, 1);
+    unsetenv("A");
+    execl(acIsh, "ish", (char*)NULL);
+    _exit(127);
+  }
+
+  close(aiIn[0]);
+  close(aiOut[1]);
+  close(aiErr[1]);
+  if (write(aiIn[1], pcInput, strlen(pcInput)) < 0)
+  {
+    perror("write");
+    exit(EXIT_FAILURE);
+  }
+  close(aiIn[1]);
+  /* ish only writes a few lines, well within a pipe, so reading one
+     pipe to its end before the other cannot block it. */
+  readAll(aiOut[0], pcOut);
+  readAll(aiErr[0], pcErr);
+  close(aiOut[0]);
+  close(aiErr[0]);
+  if ((waitpid(pid, &iStatus, 0) != pid) || ! WIFEXITED(iStatus))
+    return -1;
+  return WEXITSTATUS(iStatus);
+}
+
+/*--------------------------------------------------------------------*/
+
+#define CASE(pcLine, pcError) check(__LINE__, pcLine, pcError)
+
+static void check(int iLineNum, const char *pcLine, const char *pcError)
+
+  /* Run pcLine, then "printenv A" and "pwd", through ish.  Report the
+     case at line iLineNum as failed unless ish prints pcError, ending
+     in a newline, as its only error and exits normally, A is still
+     unset, the directory unchanged, and no file has been made in it. */
+
+{
+  static char acOut[MAX_OUTPUT];
+  static char acErr[MAX_OUTPUT];
+  char acInput[MAX_OUTPUT];
+  char acExpected[MAX_OUTPUT];
+  struct stat sStat;
+  int iStatus;
+
+  snprintf(acInput, sizeof(acInput), "%s\nprintenv A\npwd\n", pcLine);
+  iStatus = runIsh(acInput, acOut, acErr);
+
+  /* The prompts of the three lines, pwd's output, and the last prompt,
+     which EOF ends. */
+  snprintf(acExpected, sizeof(acExpected), "%% %% %% %s\n%% \n", acDir);
+  if ((iStatus != 0) || (strcmp(acOut, acExpected) != 0) ||
+      (strcmp(acErr, pcError) != 0) || (stat("f", &sStat) == 0))
+  {
+    printf("testparent: test at line %d failed.\n", iLineNum);
+    printf("  status %d, stdout \"%s\", stderr \"%s\"\n", iStatus, acOut,
+           acErr);
+    fflush(stdout);
+    iFailures++;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testMisused(void)
+
+  /* A shell builtin followed by a pipe, redirection or '&' fails with
+     its usage message, and does nothing else. */
+
+{
+  CASE("hash &", "ish: hash takes command names\n");
+  CASE("hash -r &", "ish: hash takes command names\n");
+  CASE("rehash > f", "ish: rehash takes no parameters\n");
+  CASE("cd /tmp |", "ish: Missing command name\n");
+  CASE("cd /tmp | cat", "ish: cd takes one parameter\n");
+  CASE("cd < /dev/null", "ish: cd takes one parameter\n");
+  CASE("cd /tmp &", "ish: cd takes one parameter\n");
+  CASE("setenv A B > f", "ish: setenv takes one or two parameters\n");
+  CASE("setenv A > f", "ish: setenv takes one or two parameters\n");
+  CASE("setenv A B | cat", "ish: setenv takes one or two parameters\n");
+  CASE("unsetenv A < f", "ish: unsetenv takes one parameter\n");
+  CASE("exit &", "ish: exit takes no parameters\n");
+  CASE("exit | cat", "ish: exit takes no parameters\n");
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Run the tests.  Return 0 iff all of them pass. */
+
+{
+  if (realpath("../ish", acIsh) == NULL)
+  {
+    perror("testparent: ../ish");
+    return 1;
+  }
+  if ((mkdtemp(acDir) == NULL) || (chdir(acDir) < 0))
+  {
+    perror("testparent: mkdtemp");
+    return 1;
+  }
+
+  testMisused();
+
+  rmdir(acDir);
+  if (iFailures > 0)
+  {
+    printf("testparent: %d test(s) failed.\n", iFailures);
+    return 1;
+  }
+  printf("testparent: all tests passed.\n");
+  return 0;
+}
@@ -0,0 +1,167 @@
+/*--------------------------------------------------------------------*/
+/* testpathcache.c                                                    */
+/* A test client for the PATH cache.                                  */
+/*--------------------------------------------------------------------*/
+
+#include "../pathcache.h"
+#include "../symbol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*--------------------------------------------------------------------*/
+
+static int iFailures = 0;
+
+#define ASSURE(iSuccessful) assure(iSuccessful, __LINE__)
+
+static void assure(int iSuccessful, int iLineNum)
+
+  /* If !iSuccessful, report the test at line iLineNum as failed. */
+
+{
+  if (! iSuccessful)
+  {
+    printf("testpathcache: test at line %d failed.\n", iLineNum);
+    fflush(stdout);
+    iFailures++;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* An empty directory for the commands the tests make. */
+static char acDir[] = "/tmp/testpathcacheXXXXXX";
+
+static void makeCommand(const char *pcName)
+
+  /* Make an executable file pcName in acDir. */
+
+{
+  char acFile[64];
+  int iFd;
+
+  snprintf(acFile, sizeof(acFile), "%s/%s", acDir, pcName);
+  iFd = open(acFile, O_WRONLY | O_CREAT | O_TRUNC, 0700);
+  ASSURE(iFd >= 0);
+  close(iFd);
+}
+
+static void removeCommand(const char *pcName)
+
+  /* Remove the file pcName from acDir. */
+
+{
+  char acFile[64];
+
+  snprintf(acFile, sizeof(acFile), "%s/%s", acDir, pcName);
+  unlink(acFile);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testMissing(void)
+
+  /* A name in no PATH directory, never seen before, is remembered as
+     missing until the cache is cleared. */
+
+{
+  char acExpected[64];
+  Arena_T oArena = Arena_new();
+
+  setenv("PATH", acDir, 1);
+  ASSURE(Symbol_find("typo") == SYMBOL_NONE);
+  ASSURE(PathCache_resolve("typo", SYMBOL_NONE, oArena) == NULL);
+  ASSURE(PathCache_isCached("typo"));
+  ASSURE(Symbol_find("typo") != SYMBOL_NONE);
+
+  /* Made after the miss: the cache still says it is missing. */
+  makeCommand("typo");
+  ASSURE(PathCache_resolve("typo", SYMBOL_NONE, oArena) == NULL);
+  ASSURE(PathCache_resolve("typo", Symbol_find("typo"), oArena) == NULL);
+
+  /* hash -r, or a new PATH. */
+  PathCache_clear();
+  snprintf(acExpected, sizeof(acExpected), "%s/typo", acDir);
+  ASSURE(strcmp(PathCache_resolve("typo", SYMBOL_NONE, oArena),
+                acExpected) == 0);
+  ASSURE(PathCache_isCached("typo"));
+
+  /* Forgotten, as when its file goes away. */
+  removeCommand("typo");
+  PathCache_forget("typo");
+  ASSURE(! PathCache_isCached("typo"));
+  ASSURE(PathCache_resolve("typo", SYMBOL_NONE, oArena) == NULL);
+
+  PathCache_clear();
+  Arena_free(oArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+static void testRelative(void)
+
+  /* An answer found through a relative PATH directory is not
+     remembered; each one stays valid, in the caller's arena, across
+     later calls. */
+
+{
+  Arena_T oArena = Arena_new();
+  const char *pcOne, *pcTwo;
+
+  makeCommand("one");
+  makeCommand("two");
+  setenv("PATH", ".", 1);
+  pcOne = PathCache_resolve("one", SYMBOL_NONE, oArena);
+  pcTwo = PathCache_resolve("two", SYMBOL_NONE, oArena);
+  ASSURE((pcOne != NULL) && (strcmp(pcOne, "./one") == 0));
+  ASSURE((pcTwo != NULL) && (strcmp(pcTwo, "./two") == 0));
+  ASSURE(! PathCache_isCached("one"));
+  ASSURE(! PathCache_isCached("two"));
+
+  /* A miss through "." is not remembered either. */
+  ASSURE(PathCache_resolve("three", SYMBOL_NONE, oArena) == NULL);
+  ASSURE(! PathCache_isCached("three"));
+  makeCommand("three");
+  ASSURE(PathCache_resolve("three", SYMBOL_NONE, oArena) != NULL);
+
+  /* An empty entry is the working directory too. */
+  setenv("PATH", "/nonexistent:", 1);
+  pcOne = PathCache_resolve("one", SYMBOL_NONE, oArena);
+  ASSURE((pcOne != NULL) && (strcmp(pcOne, "./one") == 0));
+  ASSURE(strcmp(pcTwo, "./two") == 0);
+
+  removeCommand("one");
+  removeCommand("two");
+  removeCommand("three");
+  PathCache_clear();
+  Arena_free(oArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+int main(void)
+
+  /* Run the tests.  Return 0 iff all of them pass. */
+
+{
+  if ((mkdtemp(acDir) == NULL) || (chdir(acDir) < 0))
+  {
+    perror("testpathcache: mkdtemp");
+    return 1;
+  }
+
+  testMissing();
+  testRelative();
+
+  rmdir(acDir);
+  if (iFailures > 0)
+  {
+    printf("testpathcache: %d test(s) failed.\n", iFailures);
+    return 1;
+  }
+  printf("testpathcache: all tests passed.\n");
+  return 0;
+}
@@ -34,6 +34,8 @@ makeToken(enum TokenType eTokenType,
     return NULL;
 
   psToken->eType = eTokenType;
+  psToken->iOffset = -1;
+  psToken->iLength = 0;
 
   if (pcValue != NULL) {
     psToken->pcValue = (char*)malloc(strlen(pcValue) + 1);
@@ -43,7 +45,110 @@ makeToken(enum TokenType eTokenType,
     }
 
     strcpy(psToken->pcValue, pcValue);
-  } else psToken->pcValue = NULL;
+    psToken->iLength = (int)strlen(pcValue);
+    psToken->iSymbol = Symbol_findLength(pcValue,
+                                         (size_t)psToken->iLength);
+  } else {
+    psToken->pcValue = NULL;
+    psToken->iSymbol = SYMBOL_NONE;
+  }
 
   return psToken;
 }
+
+/*--------------------------------------------------------------------*/
+
+int
+TokenLine_init(struct TokenLine *psLine) {
+
+  /* Make psLine an empty TokenLine with an arena of its own.  The
+     arena gets its first block when the first value or token is
+     added.  Return FALSE (0) if insufficient memory is available for
+     the arena; psLine is then empty, and must not be added to, but may
+     be passed to TokenLine_free(). */
+
+  psLine->oArena = Arena_new();
+  CharVec_init(&psLine->sBuf, psLine->oArena);
+  TokenVec_init(&psLine->sTokens, psLine->oArena);
+  psLine->oTokens = NULL;
+  return psLine->oArena != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+TokenLine_append(struct TokenLine *psLine, const char *pc,
+    size_t uLength) {
+
+  /* Append uLength bytes at pc to the value buffer of psLine.  Return
+     FALSE (0) if insufficient memory is available. */
+
+  return CharVec_addArray(&psLine->sBuf, pc, (int)uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+TokenLine_add(struct TokenLine *psLine, enum TokenType eTokenType,
+    int iOffset, int iLength) {
+
+  /* Append a token of type eTokenType to psLine.  For a WORD token the
+     value is sBuf[iOffset...iOffset+iLength-1].  Return FALSE (0) if
+     insufficient memory is available. */
+
+  struct Token *psToken;
+
+  psToken = TokenVec_push(&psLine->sTokens);
+  if (psToken == NULL)
+    return 0;
+  psToken->eType = eTokenType;
+  psToken->pcValue = NULL;
+  psToken->iOffset = iOffset;
+  psToken->iLength = iLength;
+  psToken->iSymbol = SYMBOL_NONE;
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+TokenLine_finish(struct TokenLine *psLine) {
+
+  /* Point each WORD token at its value, look the value up in the
+     symbol table, and build psLine->oTokens.  Return FALSE (0) if
+     insufficient memory is available. */
+
+  struct Token *psToken;
+  int i;
+
+  psLine->oTokens = DynArray_newIn(psLine->oArena,
+      TokenVec_size(&psLine->sTokens));
+  if (psLine->oTokens == NULL)
+    return 0;
+
+  for (i = 0; i < TokenVec_size(&psLine->sTokens); i++) {
+    psToken = TokenVec_at(&psLine->sTokens, i);
+    if (psToken->eType == TOKEN_WORD) {
+      psToken->pcValue = CharVec_data(&psLine->sBuf) + psToken->iOffset;
+      psToken->iSymbol = Symbol_findLength(psToken->pcValue,
+                                           (size_t)psToken->iLength);
+    }
+    DynArray_set(psLine->oTokens, i, psToken);
+  }
+  return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void
+TokenLine_free(struct TokenLine *psLine) {
+
+  /* Free everything psLine owns, all of which lives in its arena.  The
+     tokens in psLine->oTokens must not be passed to freeToken(). */
+
+  Arena_free(psLine->oArena);
+  psLine->oArena = NULL;
+  psLine->oTokens = NULL;
+  CharVec_init(&psLine->sBuf, NULL);
+  TokenVec_init(&psLine->sTokens, NULL);
+}
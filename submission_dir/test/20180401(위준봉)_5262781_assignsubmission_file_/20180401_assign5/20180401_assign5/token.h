@@ -1,6 +1,12 @@
 #ifndef _TOKEN_H_
 #define _TOKEN_H_
 
+#include <stddef.h>
+#include "arena.h"
+#include "dynarray.h"
+#include "dynvec.h"
+#include "symbol.h"
+
 enum TokenType {
   TOKEN_PIPE,
   TOKEN_REDIN,
@@ -14,8 +20,52 @@ struct Token {
 
   /* The string which is the token's value. */
   char *pcValue;
+
+  /* Where the value lives in the buffer of the TokenLine that owns
+     the token, and its length.  iOffset is -1 for a token made by
+     makeToken(), which owns pcValue itself. */
+  int iOffset;
+  int iLength;
+
+  /* The symbol id of the value of a WORD token, or SYMBOL_NONE if the
+     value was not in the symbol table when the token was made.  Only
+     names the shell keeps, such as those of the builtins, are
+     interned; looking a word up never adds it. */
+  int iSymbol;
+};
+
+DYNARRAY_DEFINE(CharVec, char)
+DYNARRAY_DEFINE(TokenVec, struct Token)
+
+/* A TokenLine owns every token lexed from one command line.  WORD
+   values are kept back to back, each NUL-terminated, in sBuf; a token
+   refers to its value by offset, so lexing a line does not allocate per
+   token.  Everything the TokenLine holds comes from its arena, which the
+   Pipeline parsed from the same line shares; freeing the line releases
+   it all at once. */
+struct TokenLine {
+  /* The arena that owns the storage below. */
+  Arena_T oArena;
+
+  /* The word values. */
+  struct CharVec sBuf;
+
+  /* The tokens, stored by value. */
+  struct TokenVec sTokens;
+
+  /* Pointers to sTokens in order, for the DynArray_T based passes.
+     Built once lexing has finished. */
+  DynArray_T oTokens;
 };
 
 void freeToken(void *pvItem, void *pvExtra);
 struct Token *makeToken(enum TokenType eTokenType, char *pcValue);
+
+int TokenLine_init(struct TokenLine *psLine);
+int TokenLine_append(struct TokenLine *psLine, const char *pc,
+                     size_t uLength);
+int TokenLine_add(struct TokenLine *psLine, enum TokenType eTokenType,
+                  int iOffset, int iLength);
+int TokenLine_finish(struct TokenLine *psLine);
+void TokenLine_free(struct TokenLine *psLine);
 #endif /* _TOKEN_H_ */
@@ -30,56 +30,6 @@ errorPrint(char *input, enum PrintMode mode) {
     }
 }
 
-enum BuiltinType
-checkBuiltin(struct Token *t) {
-  /* Check null input before using string functions  */
-  assert(t);
-  assert(t->pcValue);
-
-  if (strncmp(t->pcValue, "cd", 2) == 0 && strlen(t->pcValue) == 2)
-    return B_CD;
-  if (strncmp(t->pcValue, "fg", 2) == 0 && strlen(t->pcValue) == 2)
-    return B_FG;
-  if (strncmp(t->pcValue, "exit", 4) == 0 && strlen(t->pcValue) == 4)
-    return B_EXIT;
-  else if (strncmp(t->pcValue, "setenv", 6) == 0 && strlen(t->pcValue) == 6)
-    return B_SETENV;
-  else if (strncmp(t->pcValue, "unsetenv", 8) == 0 && strlen(t->pcValue) == 8)
-    return B_USETENV;
-  else if (strncmp(t->pcValue, "alias" , 5) == 0 && strlen(t->pcValue) == 5) 
-    return B_ALIAS;
-  else
-    return NORMAL;
-}
-
-int
-countPipe(DynArray_T oTokens) {
-  int cnt = 0, i;
-  struct Token *t;
-
-  for (i = 0; i < DynArray_getLength(oTokens); i++) {
-    t = DynArray_get(oTokens, i);
-    if (t->eType == TOKEN_PIPE)
-      cnt++;
-  }
-
-  return cnt;
-}
-
-/* Check background Command */
-int
-checkBG(DynArray_T oTokens) {
-  int i;
-  struct Token *t;
-
-  for (i = 0; i < DynArray_getLength(oTokens); i++) {
-    t = DynArray_get(oTokens, i);
-    if (t->eType == TOKEN_BG)
-      return 1;
-  }
-  return 0;
-}
-
 const char* specialTokenToStr(struct Token* psToken) {
   switch(psToken->eType) {
     case TOKEN_PIPE:
@@ -105,15 +55,15 @@ const char* specialTokenToStr(struct Token* psToken) {
 void
 dumpLex(DynArray_T oTokens) {
   if (getenv("DEBUG") != NULL) {
-    int i;
+    int i = 0;
     struct Token *t;
 
-    for (i = 0; i < DynArray_getLength(oTokens); i++) {
-      t = DynArray_get(oTokens, i);
+    DYNARRAY_FOREACH(t, oTokens) {
       if (t->pcValue == NULL)
         fprintf(stderr, "[%d] %s\n", i, specialTokenToStr(t));
       else
         fprintf(stderr, "[%d] TOKEN_WORD(\"%s\")\n", i, t->pcValue);
+      i++;
     }
   }
 }